@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <optional>
+
 #include <vulkan/vulkan.hpp>
 #include <SDL.h>
 #include <SDL_vulkan.h>
@@ -9,10 +12,15 @@
 #include <glm/ext.hpp>
 
 #include <renderContext.h>
+#include <renderGraph.h>
+#include <imagePool.h>
 #include <fileLoader.hpp>
 #include <modelLoader.hpp>
 #include <camera.hpp>
+#include <shaderInterface.h>
+#include <threadPool.hpp>
 
+// keep in sync with resources/shaders/include/pushConstants.glsl
 struct PushConstants
 {
     glm::mat4 matrixVP;
@@ -20,11 +28,55 @@ struct PushConstants
     uint32_t mipLevelCount{~0U};
     glm::vec4 minBoundWorld;
     glm::vec4 maxBoundWorld;
+    uint32_t imageHeapBase{0U};  // first descriptor heap image slot of current frame
+    uint32_t bufferHeapBase{0U}; // first descriptor heap buffer slot of current frame
+    vk::DeviceAddress rootAddress{0ULL}; // RootBufferData of current frame
 };
+static_assert(sizeof(PushConstants) <= 128, "push constants must fit the minimum guaranteed size");
+
+// buffers reached by device address, keep in sync with resources/shaders/include/rootBuffer.glsl
+struct RootBufferData
+{
+    vk::DeviceAddress vertexAddress{0ULL};
+    vk::DeviceAddress indexAddress{0ULL};
+    vk::DeviceAddress hiZOutputIndexAddress{0ULL};
+    vk::DeviceAddress octreeFaceAddress{0ULL};
+    vk::DeviceAddress hiZRejectedAddress{0ULL};
+    vk::DeviceAddress clusterAddress{0ULL};
+    vk::DeviceAddress hiZVisibleClusterAddress{0ULL};
+    vk::DeviceAddress octreeNodeAddress{0ULL};
+    vk::DeviceAddress octreeQueueAddress{0ULL};
+    vk::DeviceAddress lbvhNodeAddress{0ULL};
+    vk::DeviceAddress lbvhQueueAddress{0ULL};
+    glm::uvec2 renderExtent{0U}; // sub-rect of the render targets in use
+    uint32_t triangleCount{0U};
+    uint32_t clusterCount{0U};
+    uint32_t octreeNodeCount{0U};
+    float depthRangeMin{.0f}; // linear depth range of the model in view, rewritten every frame
+    float depthRangeMax{1.f};
+    float nearPlane{.01f}; // clip planes of the main camera, rewritten every frame
+    float farPlane{1000.f};
+    uint32_t historyImageHeapBase{0U}; // temporal hi-z reads the pyramid of the previous frame through its heap slots
+    uint32_t historyValid{0U};
+    alignas(16) glm::mat4 historyMatrixVP{1.f}; // view projection the previous frame was rendered with
+    glm::vec4 cameraPosition{.0f}; // world space eye of the main camera, for the normal cone test of clusters
+};
+
+static_assert(DescriptorHeap::storageImageBinding == HEAP_STORAGE_IMAGE_BINDING && DescriptorHeap::storageBufferBinding == HEAP_STORAGE_BUFFER_BINDING,
+              "descriptor heap bindings mismatch with shaders");
 
-// the multi descriptor binding in shader's layout needs a const max size
-// max resolution to 2048
-constexpr uint32_t g_predefMaxMipLevel = 12U;
+// how many frames the CPU is allowed to record ahead of the GPU
+// every resource written during a frame is duplicated per frame in flight
+constexpr uint32_t g_maxFramesInFlight = 2U;
+
+// features some rendering modes depend on, modes whose features are missing are disabled instead of failing device creation
+static const std::vector<const char *> g_optionalDeviceExtensions = {
+    VK_EXT_FRAGMENT_SHADER_INTERLOCK_EXTENSION_NAME,
+    VK_EXT_SHADER_IMAGE_ATOMIC_INT64_EXTENSION_NAME};
+
+static_assert(IMAGE_SLOTS_PER_FRAME * g_maxFramesInFlight <= HEAP_MAX_STORAGE_IMAGE_COUNT &&
+                  BUFFER_SLOTS_PER_FRAME * g_maxFramesInFlight <= HEAP_MAX_STORAGE_BUFFER_COUNT,
+              "descriptor heap is too small for all frames in flight");
 
 enum eRenderingMode
 {
@@ -32,7 +84,14 @@ enum eRenderingMode
     RENDERING_MODE_NAIVE_ZBUFFER,
     RENDERING_MODE_SCANLINE_ZBUFFER,
     RENDERING_MODE_NAIVE_HI_ZBUFFER,
-    RENDERING_MODE_OPTIM_HI_ZBUFFER
+    RENDERING_MODE_OPTIM_HI_ZBUFFER,
+    RENDERING_MODE_VISIBILITY_BUFFER,
+    RENDERING_MODE_TILED_SCANLINE_ZBUFFER,
+    RENDERING_MODE_PACKED_SCANLINE_ZBUFFER,
+    RENDERING_MODE_PAINTER_SCANLINE_ZBUFFER,
+    RENDERING_MODE_TEMPORAL_HI_ZBUFFER,
+    RENDERING_MODE_LBVH_HI_ZBUFFER,
+    RENDERING_MODE_HYBRID_VISIBILITY_BUFFER
 };
 
 static const char *g_renderingModeText[] = {
@@ -40,7 +99,96 @@ static const char *g_renderingModeText[] = {
     "naive Z-Buffer",
     "scanline Z-Buffer",
     "naive Hierarchical Z-Buffer",
-    "optimized Hierarchical Z-Buffer"};
+    "optimized Hierarchical Z-Buffer",
+    "visibility buffer",
+    "tiled scanline Z-Buffer",
+    "packed scanline Z-Buffer",
+    "painter's scanline",
+    "temporal Hierarchical Z-Buffer",
+    "LBVH Hierarchical Z-Buffer",
+    "hybrid visibility buffer"};
+
+// every recording task owns its pool, so tasks can be recorded on different threads without locking
+struct RecordingContext
+{
+    vk::CommandPool pool{};
+    vk::CommandBuffer cmdBuffer{};
+};
+
+// everything a single frame writes on GPU, so that recording frame N + 1 never touches resources frame N is still using
+struct FrameResources
+{
+    /* render targets, taken from the target pool when this frame starts with a new window size */
+    vk::Extent2D targetExtent{}; // window size the targets are used with, a sub-rect of their allocated extent
+    ImagePool::Handle zBufferTarget{ImagePool::invalidHandle};
+    ImagePool::Handle colorBufferTarget{ImagePool::invalidHandle};
+    ImagePool::Handle emptyBufferTarget{ImagePool::invalidHandle};
+    vk::Image zBuffer{};
+    vk::Image colorBuffer{};
+    vk::Image emptyBuffer{}; // an empty depth buffer for hi-z post rendering
+
+    /* model sized buffers, recreated with the model */
+    std::shared_ptr<Buffer> scanlineBuffer; // filled scanline range
+    std::shared_ptr<Buffer> scanlineTileEntries; // scanline indices binned per screen tile
+    std::shared_ptr<Buffer> scanlineSegmentOffsets; // first work segment of each scanline
+    std::array<std::shared_ptr<Buffer>, 2> scanlineSortPairs; // (row & depth key, scanline index), ping-ponged by the radix sort
+    std::shared_ptr<Buffer> scanlineSortHistogram; // digit offsets of every sort block
+    std::shared_ptr<Buffer> hiZOutputIndexBuffer; // indices of the faces passing hi-z culling, drawn against the model vertex buffer
+    std::shared_ptr<Buffer> octreeQueues; // work queue of the octree traversal & visible leaves, see OctreeQueues in rootBuffer.glsl
+    std::shared_ptr<Buffer> lbvhNodes; // BvhNode of the lbvh rebuilt every frame
+    std::shared_ptr<Buffer> lbvhQueues; // node queues of the lbvh traversal, see BvhQueues in rootBuffer.glsl
+    std::shared_ptr<Buffer> hiZRejectedFaces; // dispatch size, count and indices of faces left for the second temporal hi-z phase, or of the large faces of hybrid visibility
+    std::shared_ptr<Buffer> hiZVisibleClusters; // dispatch size, count and indices of clusters passing the naive hi-z cluster culling
+    std::shared_ptr<Buffer> rootBuffer; // host visible RootBufferData, rewritten with the model
+
+    /* fixed sized resources */
+    std::shared_ptr<Buffer> scanlineGlobalPropertyBuffer; // dispatch parameters, active scanline count in order
+    std::shared_ptr<Buffer> hiZIndirectRenderBuffer;
+
+    /* passes of current rendering mode, scanline spinlock & tile images are transient images of these graphs */
+    RenderGraph prepassGraph{}; // graphics work feeding async compute
+    RenderGraph computeGraph{}; // async compute work
+    eRenderingMode graphMode{eRenderingMode::RENDERING_MODE_DEFAULT_WIREFRAME};
+    bool graphDirty{true}; // set whenever a resource imported by the graphs is recreated
+    vk::Image historyZBuffer{}; // z-buffer of the previous frame imported by the temporal hi-z graph, empty without history
+    glm::mat4 matrixVP{1.f};   // view projection of the last submission
+
+    /* descriptor heap ranges holding resources above */
+    uint32_t imageHeapBase{0U};
+    uint32_t bufferHeapBase{0U};
+
+    /* submission */
+    RecordingContext prepass{}; // graphics work feeding async compute
+    RecordingContext compute{}; // async compute work
+    RecordingContext post{};    // graphics work consuming async compute, executes scene & ui
+    RecordingContext scene{};   // secondary, final blit of current rendering mode
+    RecordingContext ui{};      // secondary, imgui draw data
+    vk::Semaphore prepassFinishedSemaphore{};
+    vk::Semaphore computeFinishedSemaphore{};
+    vk::Fence inFlightFence{}; // signaled when GPU has finished every command of this frame
+
+    TimestampProfiler profiler{};
+};
+
+// command line driven rendering without window, see headless/headless.cpp
+struct HeadlessOptions
+{
+    std::filesystem::path modelPath{"./resources/models/cgaxis_107_11_cafe_stall_obj.obj"};
+    std::vector<eRenderingMode> modes{eRenderingMode::RENDERING_MODE_SCANLINE_ZBUFFER};
+    vk::Extent2D size{1280U, 720U};
+    uint32_t frameCount{16U};
+    std::optional<std::array<glm::vec3, 2>> camera{}; // eye and center, fitted to the model when empty
+    std::filesystem::path outputPath{"frame.ppm"};   // mode name is appended when several modes are rendered
+};
+
+// offscreen replacement of a swapchain image, one per frame in flight
+struct HeadlessTarget
+{
+    std::shared_ptr<Image> colorImage;
+    vk::ImageView colorView{};
+    vk::Framebuffer framebuffer{};
+    std::shared_ptr<Buffer> readbackBuffer; // host visible copy of the color image after every frame
+};
 
 class ApplicationBase
 {
@@ -49,6 +197,7 @@ public:
     void initSurface(SDL_Window *windowHandle);
     void initSwapchain();
     void initImGui(SDL_Window *windowHandle);
+    void initCamera();
 
     void displayGui(SDL_Window *windowHandle);
 
@@ -80,45 +229,93 @@ public:
 
     /* rendering detail */
     void reloadModel(const std::filesystem::path &filePath);
-    void recreateRenderTargets();
+    void updateRenderTargets(FrameResources &frame);
+    void destroyRenderTargets(FrameResources &frame);
+    void updateRootData(FrameResources &frame);
+    vk::Image getTemporalHistory(const FrameResources &frame) const;
     void createStaticResources();
-    void createRenderer();
+    void createRenderer(const std::filesystem::path &modelPath = "./resources/models/cgaxis_107_11_cafe_stall_obj.obj");
     void updateRenderData();
+    void buildFrameGraphs(FrameResources &frame);
+
+    bool usePrepass() const
+    {
+        return m_renderingMode == eRenderingMode::RENDERING_MODE_NAIVE_HI_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_OPTIM_HI_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_TEMPORAL_HI_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_LBVH_HI_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_VISIBILITY_BUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_HYBRID_VISIBILITY_BUFFER;
+    }
+    // both modes resolve the same visibility buffer, the hybrid one fills it in compute & hardware
+    bool isVisibilityMode() const
+    {
+        return m_renderingMode == eRenderingMode::RENDERING_MODE_VISIBILITY_BUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_HYBRID_VISIBILITY_BUFFER;
+    }
+    bool useAsyncCompute() const
+    {
+        return isScanlineMode() ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_NAIVE_HI_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_OPTIM_HI_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_LBVH_HI_ZBUFFER;
+    }
+    // scanline modes fill the color buffer on async compute, which is then blitted
+    bool isScanlineMode() const
+    {
+        return m_renderingMode == eRenderingMode::RENDERING_MODE_SCANLINE_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_TILED_SCANLINE_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_PACKED_SCANLINE_ZBUFFER ||
+               m_renderingMode == eRenderingMode::RENDERING_MODE_PAINTER_SCANLINE_ZBUFFER;
+    }
+    // pixel interlock modes need the optional interlock extension
+    bool isModeSupported(eRenderingMode mode) const
+    {
+        return m_interlockSupported || (mode != eRenderingMode::RENDERING_MODE_NAIVE_ZBUFFER &&
+                                        mode != eRenderingMode::RENDERING_MODE_NAIVE_HI_ZBUFFER &&
+                                        mode != eRenderingMode::RENDERING_MODE_OPTIM_HI_ZBUFFER &&
+                                        mode != eRenderingMode::RENDERING_MODE_TEMPORAL_HI_ZBUFFER &&
+                                        mode != eRenderingMode::RENDERING_MODE_LBVH_HI_ZBUFFER);
+    }
 
-    void clearZBuffer(vk::CommandBuffer &cmdBuffer);
-    void render(vk::CommandBuffer &cmdBuffer);
-    void finalBlit(vk::CommandBuffer &cmdBuffer);
+    void clearZBuffer(vk::CommandBuffer &cmdBuffer, FrameResources &frame);
+    void renderPrepass(vk::CommandBuffer &cmdBuffer, FrameResources &frame);
+    void render(vk::CommandBuffer &cmdBuffer, FrameResources &frame);
+    void acquireComputeResults(vk::CommandBuffer &cmdBuffer, FrameResources &frame);
+    void finalBlit(vk::CommandBuffer &cmdBuffer, FrameResources &frame);
+    void recordPost(FrameResources &frame, const vk::RenderPassBeginInfo &beginInfo);
+    void bindDescriptorHeap(vk::CommandBuffer &cmdBuffer, vk::PipelineBindPoint bindPoint);
+    void updateProfileResults(FrameResources &frame);
     void renderFrame();
+    void submitFrame(FrameResources &frame, vk::Framebuffer frameBuffer, vk::Semaphore acquireSemaphore, vk::Semaphore renderCompleteSemaphore);
+
+    /* headless */
+    int runHeadless(const HeadlessOptions &options);
+    void initHeadless(vk::Extent2D size);
+    void renderHeadlessFrame();
+    void recordReadback(vk::CommandBuffer &cmdBuffer);
+    void writeReadback(const std::filesystem::path &ppmPath);
+    void destroyHeadless();
 
     void destroy();
+    void destroyRenderer();
 
 protected:
     /* resources */
     std::shared_ptr<Buffer> m_vertexBuffer;
     std::shared_ptr<Buffer> m_indexBuffer;
+    std::shared_ptr<Buffer> m_clusterBuffer; // FaceCluster of every HIZ_CLUSTER_SIZE consecutive faces
+    std::shared_ptr<Buffer> m_octreeNodeBuffer; // FaceOctreeNode of the static octree, level by level
+    std::shared_ptr<Buffer> m_octreeFaceBuffer; // face indices sorted by octree leaf
     size_t m_vertexCount{};
     size_t m_triangleCount{};
+    size_t m_clusterCount{};
     BoundingBox m_bounding{};
-    std::shared_ptr<Buffer> m_scanlineBuffer;               // filled scanline range
-    std::shared_ptr<Buffer> m_scanlineGlobalPropertyBuffer; // dispatch parameters, active scanline count in order
-    std::shared_ptr<Buffer> m_hiZOutputVertexBuffer;
-    std::shared_ptr<Buffer> m_hiZIndirectRenderBuffer;
-    size_t m_octreeLevelCount{8};
-    size_t m_octreeStartLevel{3};
-    std::shared_ptr<Buffer> m_faceIndicesOfOctree;
-    std::shared_ptr<Image> m_zBuffer;
-    std::vector<vk::ImageView> m_zBufferMipViews{};
-    std::shared_ptr<Image> m_scanlineBufferSpinlock{};
-    vk::ImageView m_scanlineBufferSpinlockView;
-    std::shared_ptr<Image> m_octreeLinkHeader;
-    std::vector<vk::ImageView> m_octreeLinkHeaderMipViews{};
-    std::shared_ptr<Image> m_octreeMarker;
-    std::vector<vk::ImageView> m_octreeMarkerMipViews{};
-    std::shared_ptr<Image> m_colorBuffer;
-    vk::ImageView m_colorBufferView;
-    std::shared_ptr<Image> m_emptyBuffer; // an empty depth buffer for hi-z post rendering
-    vk::ImageView m_emptyBufferView;
+    size_t m_octreeNodeCount{};
+    std::array<FrameResources, g_maxFramesInFlight> m_frames{};
+    uint32_t m_frameIndex{0U};
     PushConstants m_pushConstants{};
+    ImagePool m_targetPool{}; // keeps targets of recent window sizes, so resizing back and forth does not reallocate
     eRenderingMode m_renderingMode{eRenderingMode::RENDERING_MODE_DEFAULT_WIREFRAME};
     Camera m_mainCamera{};
 
@@ -126,49 +323,64 @@ protected:
     RenderContext m_renderContext{};
     vk::CommandPool m_internalTransferPool{};
     vk::Fence m_internalTransferFence{};
+    uint32_t m_graphicsQueueFamily{~0U};
+    uint32_t m_computeQueueFamily{~0U}; // same as graphics one when there is no dedicated compute family
+    bool m_computeTimestampSupported{false};
+    bool m_interlockSupported{false};
+    bool m_imageInt64AtomicsSupported{false}; // visibility buffer packs depth & primitive id into 64 bits, otherwise into 32 bits
+    ThreadPool m_recordingThreads{}; // records independent command buffers of a frame in parallel
 
-    vk::DescriptorPool m_descPool{};
-    vk::DescriptorSetLayout m_zBufferSetLayout{};
-    vk::DescriptorSet m_zBufferSet{};
-    vk::DescriptorSetLayout m_geometrySetLayout{};
-    vk::DescriptorSet m_geometrySet{};
-    vk::DescriptorSetLayout m_scanlineSetLayout{};
-    vk::DescriptorSet m_scanlineSet{};
-    vk::DescriptorSetLayout m_hiZOutputSetLayout{};
-    vk::DescriptorSet m_hiZOutputSet{};
-    vk::DescriptorSetLayout m_octreeSetLayout{};
-    vk::DescriptorSet m_octreeSet{};
+    DescriptorHeap m_descriptorHeap{};
+    vk::PipelineLayout m_pipelineLayout{}; // shared by all pipelines
 
     vk::RenderingInfo m_zPrepassRenderingInfo{};
 
-    vk::PipelineLayout m_defaultPipelineLayout{};
     vk::Pipeline m_defaultFramePipeline{};
-    vk::PipelineLayout m_naiveZBufferPipelineLayout{};
     vk::Pipeline m_naiveZBufferPipeline{};
-    vk::PipelineLayout m_scanlineZBufferPipelineLayout{};
     vk::Pipeline m_scanlineZBufferInitPipeline{};
     vk::Pipeline m_scanlineZBufferWorkPipeline{};
-    vk::PipelineLayout m_zPrepassPipelinelayout{};
+    vk::Pipeline m_scanlineSegmentScanPipeline{};
+    vk::Pipeline m_radixSortHistogramPipeline{};
+    vk::Pipeline m_radixSortScanPipeline{};
+    vk::Pipeline m_radixSortScatterPipeline{};
+    vk::Pipeline m_scanlinePainterFillPipeline{};
+    vk::Pipeline m_scanlineTileCountPipeline{};
+    vk::Pipeline m_scanlineTileScanPipeline{};
+    vk::Pipeline m_scanlineTileScatterPipeline{};
+    vk::Pipeline m_scanlineTileResolvePipeline{};
+    vk::Pipeline m_scanlinePackedWorkPipeline{};
+    vk::Pipeline m_scanlinePackedResolvePipeline{};
     vk::Pipeline m_zPrepassPipeline{};
-    vk::PipelineLayout m_zBufferMipMappingPipelineLayout{};
     vk::Pipeline m_zBufferMipMappingPipeline{};
-    vk::PipelineLayout m_octreeInitPipelineLayout{};
-    vk::Pipeline m_octreeInitPipeline{};
-    vk::PipelineLayout m_hiZBufferOutputPipelineLayout{};
+    vk::Pipeline m_octreeLeafCullingPipeline{};
+    vk::Pipeline m_lbvhMortonPipeline{};
+    vk::Pipeline m_lbvhHierarchyPipeline{};
+    vk::Pipeline m_lbvhRefitPipeline{};
+    vk::Pipeline m_lbvhFrontierPipeline{};
+    vk::Pipeline m_lbvhSubtreePipeline{};
+    vk::Pipeline m_hiZClusterCullingPipeline{};
     vk::Pipeline m_naiveHiZBufferWorkPipeline{};
     vk::Pipeline m_optimHiZBufferWorkPipeline{};
+    vk::Pipeline m_temporalHiZCullingPipeline{};
+    vk::Pipeline m_temporalHiZRecheckPipeline{};
     vk::Pipeline m_hiZBufferPostRenderPipeline{};
-    vk::PipelineLayout m_blitPipelineLayout{};
+    vk::Pipeline m_visibilityRasterPipeline{};
+    vk::Pipeline m_hybridRasterPipeline{};
+    vk::Pipeline m_visibilityHybridRasterPipeline{};
+    vk::Pipeline m_visibilityResolvePipeline{};
     vk::Pipeline m_blitPipeline{};
-    vk::MemoryBarrier2 m_shaderRWBarrier{};
     vk::MemoryBarrier2 m_imageClearBarrier{};
 
     /* ui display */
+    // headless rendering fills RenderPass, Width & Height only, so pipelines & post pass need no special casing
     ImGui_ImplVulkanH_Window m_mainWindow{};
     vk::Extent2D m_size{};
     vk::DescriptorPool m_guiDescPool{};
     bool m_shouldWindowClose{false};
     bool m_swapchainDirty{false};
+    bool m_headless{false};
+    vk::RenderPass m_headlessRenderPass{};
+    std::array<HeadlessTarget, g_maxFramesInFlight> m_headlessTargets{};
 
     /* misc */
     size_t m_frequency{};
@@ -177,5 +389,8 @@ protected:
     float m_dirtyTimer{.0f};
     size_t m_fpsCounter{};
     size_t m_fraps{};
+    std::vector<TimestampProfiler::Section> m_profileResults{};
+    TimestampProfiler::Section m_lastGraphicsSection{};
+    double m_asyncComputeOverlapMs{.0};
     bool m_leftMouseButton{false};
 };
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include <chrono>
+#include <fstream>
+#include <map>
+
+#define GLM_FORCE_SWIZZLE
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "applicationBase.hpp"
+
+static constexpr vk::Format g_headlessColorFormat = vk::Format::eR8G8B8A8Unorm;
+
+// no surface and no swapchain, so it also runs on display-less machines, e.g. with lavapipe
+void ApplicationBase::initHeadless(vk::Extent2D size)
+{
+    m_headless = true;
+    m_renderContext.init({}, {}, {}, {}, g_optionalDeviceExtensions);
+
+    m_size = size;
+    m_mainWindow.Width = static_cast<int>(size.width);
+    m_mainWindow.Height = static_cast<int>(size.height);
+    initCamera();
+
+    // same single subpass layout as the swapchain render pass, but ends ready for the readback copy
+    vk::AttachmentDescription attachment{};
+    attachment.setFormat(g_headlessColorFormat)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eStore)
+        .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+        .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+        .setInitialLayout(vk::ImageLayout::eUndefined)
+        .setFinalLayout(vk::ImageLayout::eTransferSrcOptimal);
+    vk::AttachmentReference colorReference{0U, vk::ImageLayout::eColorAttachmentOptimal};
+    vk::SubpassDescription subpass{};
+    subpass.setPipelineBindPoint(vk::PipelineBindPoint::eGraphics)
+        .setColorAttachments(colorReference);
+    std::array dependencies = {
+        // previous readback copy of the same target must finish before it is cleared
+        vk::SubpassDependency{VK_SUBPASS_EXTERNAL, 0U,
+                              vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                              {}, vk::AccessFlagBits::eColorAttachmentWrite},
+        vk::SubpassDependency{0U, VK_SUBPASS_EXTERNAL,
+                              vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eTransfer,
+                              vk::AccessFlagBits::eColorAttachmentWrite, vk::AccessFlagBits::eTransferRead}};
+    vk::RenderPassCreateInfo renderPassCreateInfo{};
+    renderPassCreateInfo.setAttachments(attachment)
+        .setSubpasses(subpass)
+        .setDependencies(dependencies);
+    m_headlessRenderPass = m_renderContext.getDeviceHandle()->createRenderPass(renderPassCreateInfo, allocationCallbacks);
+    m_mainWindow.RenderPass = m_headlessRenderPass;
+
+    vk::ImageCreateInfo imageCreateInfo{};
+    imageCreateInfo.setImageType(vk::ImageType::e2D)
+        .setFormat(g_headlessColorFormat)
+        .setExtent(vk::Extent3D{size.width, size.height, 1U})
+        .setMipLevels(1U)
+        .setArrayLayers(1U)
+        .setSamples(vk::SampleCountFlagBits::e1)
+        .setTiling(vk::ImageTiling::eOptimal)
+        .setUsage(vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc)
+        .setSharingMode(vk::SharingMode::eExclusive)
+        .setInitialLayout(vk::ImageLayout::eUndefined);
+    vk::ImageViewCreateInfo viewCreateInfo{};
+    viewCreateInfo.setViewType(vk::ImageViewType::e2D)
+        .setFormat(g_headlessColorFormat)
+        .setComponents(vk::ComponentSwizzle::eIdentity)
+        .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
+    for (auto &target : m_headlessTargets)
+    {
+        target.colorImage = m_renderContext.createImage(imageCreateInfo);
+        viewCreateInfo.setImage(*target.colorImage);
+        target.colorView = m_renderContext.getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks);
+
+        vk::FramebufferCreateInfo framebufferCreateInfo{};
+        framebufferCreateInfo.setRenderPass(m_headlessRenderPass)
+            .setAttachments(target.colorView)
+            .setWidth(size.width)
+            .setHeight(size.height)
+            .setLayers(1U);
+        target.framebuffer = m_renderContext.getDeviceHandle()->createFramebuffer(framebufferCreateInfo, allocationCallbacks);
+
+        target.readbackBuffer = m_renderContext.createBuffer(sizeof(uint32_t) * size.width * size.height, vk::BufferUsageFlagBits::eTransferDst,
+                                                             vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    }
+}
+
+void ApplicationBase::renderHeadlessFrame()
+{
+    auto &frame = m_frames[m_frameIndex];
+    m_renderContext.getDeviceHandle()->waitForFences(frame.inFlightFence, VK_TRUE, UINT64_MAX);
+    m_renderContext.getDeviceHandle()->resetFences(frame.inFlightFence);
+    submitFrame(frame, m_headlessTargets[m_frameIndex].framebuffer, {}, {});
+}
+
+// recorded after the post render pass, which leaves the target in transfer src layout
+void ApplicationBase::recordReadback(vk::CommandBuffer &cmdBuffer)
+{
+    const auto &target = m_headlessTargets[m_frameIndex];
+    vk::BufferImageCopy region{};
+    region.setImageSubresource(vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eColor, 0U, 0U, 1U})
+        .setImageExtent(vk::Extent3D{m_size.width, m_size.height, 1U});
+    cmdBuffer.copyImageToBuffer(*target.colorImage, vk::ImageLayout::eTransferSrcOptimal, *target.readbackBuffer, region);
+
+    vk::MemoryBarrier2 hostReadBarrier{};
+    hostReadBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eCopy)
+        .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+        .setDstStageMask(vk::PipelineStageFlagBits2::eHost)
+        .setDstAccessMask(vk::AccessFlagBits2::eHostRead);
+    cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, hostReadBarrier});
+}
+
+// binary PPM of the last submitted frame
+void ApplicationBase::writeReadback(const std::filesystem::path &ppmPath)
+{
+    const uint32_t lastFrameIndex = (m_frameIndex + g_maxFramesInFlight - 1U) % g_maxFramesInFlight;
+    m_renderContext.getDeviceHandle()->waitForFences(m_frames[lastFrameIndex].inFlightFence, VK_TRUE, UINT64_MAX);
+
+    auto &readbackBuffer = *m_headlessTargets[lastFrameIndex].readbackBuffer;
+    const auto *pixels = static_cast<const uint8_t *>(readbackBuffer.map());
+    std::ofstream file(ppmPath, std::ios::binary);
+    file << "P6\n"
+         << m_size.width << " " << m_size.height << "\n255\n";
+    for (size_t i = 0; i < static_cast<size_t>(m_size.width) * m_size.height; ++i)
+        file.write(reinterpret_cast<const char *>(pixels + i * 4), 3);
+    readbackBuffer.unmap();
+
+    if (!file)
+        spdlog::error("Failed to write readback image {}.", ppmPath.string());
+}
+
+void ApplicationBase::destroyHeadless()
+{
+    m_renderContext.getDeviceHandle()->waitIdle();
+    for (auto &target : m_headlessTargets)
+    {
+        m_renderContext.getDeviceHandle()->destroy(target.framebuffer, allocationCallbacks);
+        m_renderContext.getDeviceHandle()->destroy(target.colorView, allocationCallbacks);
+        target.colorImage.reset();
+        target.readbackBuffer.reset();
+    }
+    m_renderContext.getDeviceHandle()->destroy(m_headlessRenderPass, allocationCallbacks);
+    m_mainWindow.RenderPass = VK_NULL_HANDLE;
+    destroyRenderer();
+}
+
+// renders every requested mode for a fixed number of frames, then prints timings and writes the last frame of each mode
+int ApplicationBase::runHeadless(const HeadlessOptions &options)
+{
+    initHeadless(options.size);
+    createRenderer(options.modelPath);
+    if (options.camera.has_value())
+        m_mainCamera.setLookat(options.camera->at(0), options.camera->at(1), {.0f, 1.f, .0f});
+
+    for (const auto mode : options.modes)
+    {
+        if (!isModeSupported(mode))
+        {
+            spdlog::warn("{} is not supported by this device, skipped.", g_renderingModeText[mode]);
+            continue;
+        }
+        m_renderingMode = mode;
+        m_profileResults.clear();
+
+        // gpu timings arrive one round of frames in flight late, so the first results still belong to the previous mode
+        std::map<std::string, std::pair<double, uint32_t>> sectionTimings{};
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < options.frameCount; ++i)
+        {
+            updateRenderData();
+            renderHeadlessFrame();
+            if (i < g_maxFramesInFlight)
+                continue;
+            for (const auto &section : m_profileResults)
+            {
+                auto &[totalMs, count] = sectionTimings[section.name];
+                totalMs += section.durationMs();
+                ++count;
+            }
+        }
+        m_renderContext.getDeviceHandle()->waitIdle();
+        const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        spdlog::info("{}: {} frames at {}x{}, {:.3f}ms per frame", g_renderingModeText[mode], options.frameCount, m_size.width, m_size.height,
+                     elapsedMs / std::max(options.frameCount, 1U));
+        for (const auto &[name, timing] : sectionTimings)
+            spdlog::info("    {}: {:.3f}ms", name, timing.first / timing.second);
+
+        auto outputPath = options.outputPath;
+        if (options.modes.size() > 1)
+            outputPath.replace_filename(outputPath.stem().string() + "_" + std::to_string(mode) + outputPath.extension().string());
+        writeReadback(outputPath);
+    }
+
+    destroyHeadless();
+    return 0;
+}
@@ -1,9 +1,22 @@
+#include <cstddef>
 #include <iomanip>
 
 #define GLM_FORCE_SWIZZLE
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include "applicationBase.hpp"
 
+// keep in sync with GlobalProperty in resources/shaders/include/bindless.glsl, each part starts with its indirect dispatch
+struct ScanlineGlobalProperty
+{
+    glm::uvec3 workgroupCount;
+    uint32_t scanlineCount;
+    glm::uvec3 segmentWorkgroupCount;
+    uint32_t segmentCount;
+    glm::uvec3 sortWorkgroupCount;
+    uint32_t sortPass;
+};
+static_assert(sizeof(ScanlineGlobalProperty) == sizeof(glm::uvec4) * 3, "std430 packs every uvec3 with the following uint");
+
 struct alignas(16) ScanlineAttribute
 {
     glm::vec3 faceNormal;
@@ -12,6 +25,7 @@ struct alignas(16) ScanlineAttribute
     int32_t y;
     float zStart;
     float dzdx;
+    uint32_t faceIndex;
 };
 
 constexpr size_t calWorkGroupCount(const size_t &renderSize, const size_t &threadSize)
@@ -21,291 +35,269 @@ constexpr size_t calWorkGroupCount(const size_t &renderSize, const size_t &threa
 
 void ApplicationBase::reloadModel(const std::filesystem::path &filePath)
 {
+    // frames in flight may still read the old model
+    m_renderContext.getDeviceHandle()->waitIdle();
+
     if (m_vertexBuffer)
         m_vertexBuffer.reset();
     if (m_indexBuffer)
         m_indexBuffer.reset();
-    if (m_scanlineBuffer)
-        m_scanlineBuffer.reset();
-    if (m_hiZOutputVertexBuffer)
-        m_hiZOutputVertexBuffer.reset();
+    if (m_clusterBuffer)
+        m_clusterBuffer.reset();
+    if (m_octreeNodeBuffer)
+        m_octreeNodeBuffer.reset();
+    if (m_octreeFaceBuffer)
+        m_octreeFaceBuffer.reset();
+    for (auto &frame : m_frames)
+    {
+        if (frame.scanlineBuffer)
+            frame.scanlineBuffer.reset();
+        if (frame.scanlineTileEntries)
+            frame.scanlineTileEntries.reset();
+        if (frame.scanlineSegmentOffsets)
+            frame.scanlineSegmentOffsets.reset();
+        for (auto &sortPairs : frame.scanlineSortPairs)
+            sortPairs.reset();
+        if (frame.scanlineSortHistogram)
+            frame.scanlineSortHistogram.reset();
+        if (frame.hiZOutputIndexBuffer)
+            frame.hiZOutputIndexBuffer.reset();
+        if (frame.octreeQueues)
+            frame.octreeQueues.reset();
+        if (frame.lbvhNodes)
+            frame.lbvhNodes.reset();
+        if (frame.lbvhQueues)
+            frame.lbvhQueues.reset();
+        if (frame.hiZRejectedFaces)
+            frame.hiZRejectedFaces.reset();
+        if (frame.hiZVisibleClusters)
+            frame.hiZVisibleClusters.reset();
+    }
 
     auto [vertices, indices, box] = loadModel(filePath);
-    m_vertexBuffer = m_renderContext.createBuffer(vertices, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer);
-    m_indexBuffer = m_renderContext.createBuffer(indices, vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eStorageBuffer);
+    m_vertexBuffer = m_renderContext.createBuffer(vertices, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+    m_indexBuffer = m_renderContext.createBuffer(indices, vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress);
     m_vertexCount = vertices.size();
     m_triangleCount = indices.size() / 3;
     m_bounding = box;
+    // clusters are bounded once here, so naive hi-z culls most of the model without touching its faces
+    const auto clusters = buildFaceClusters(vertices, indices, HIZ_CLUSTER_SIZE);
+    m_clusterBuffer = m_renderContext.createBuffer(clusters, vk::BufferUsageFlagBits::eShaderDeviceAddress);
+    m_clusterCount = clusters.size();
+    // the geometry never changes, so its octree is built once here and only traversed per frame
+    const auto octree = buildFaceOctree(vertices, indices, box, OCTREE_LEAF_SIZE, OCTREE_MAX_DEPTH);
+    m_octreeNodeBuffer = m_renderContext.createBuffer(octree.nodes, vk::BufferUsageFlagBits::eShaderDeviceAddress);
+    m_octreeFaceBuffer = m_renderContext.createBuffer(octree.faces, vk::BufferUsageFlagBits::eShaderDeviceAddress);
+    m_octreeNodeCount = octree.nodes.size();
     m_mainCamera.fit(box, glm::mat4(1.f), true, false, (float)m_size.width / m_size.height);
 
-    // create scanline required buffers
-    m_scanlineBuffer = m_renderContext.createBuffer(sizeof(ScanlineAttribute) * 1024 * (m_triangleCount / glm::length(box.getExtent())), vk::BufferUsageFlagBits::eStorageBuffer);
-
-    // create hi-z required buffers
-    m_hiZOutputVertexBuffer = m_renderContext.createBuffer(sizeof(glm::vec4) * indices.size(), vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer);
-
-    // update geometry descriptors
-    std::vector<vk::WriteDescriptorSet> writeDescs{};
-    writeDescs.resize(4);
-    vk::DescriptorBufferInfo vertexBufferInfo{*m_vertexBuffer, 0ULL, VK_WHOLE_SIZE};
-    vk::DescriptorBufferInfo indexBufferInfo{*m_indexBuffer, 0ULL, VK_WHOLE_SIZE};
-    writeDescs[0].setDstSet(m_geometrySet).setDstBinding(0).setDescriptorCount(1U).setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(vertexBufferInfo);
-    writeDescs[1].setDstSet(m_geometrySet).setDstBinding(1).setDescriptorCount(1U).setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(indexBufferInfo);
-    vk::DescriptorBufferInfo scanlineBufferInfo{*m_scanlineBuffer, 0ULL, VK_WHOLE_SIZE};
-    writeDescs[2].setDstSet(m_scanlineSet).setDstBinding(0).setDescriptorCount(1U).setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(scanlineBufferInfo);
-    vk::DescriptorBufferInfo hiZOutputVertexBufferInfo{*m_hiZOutputVertexBuffer, 0ULL, VK_WHOLE_SIZE};
-    writeDescs[3].setDstSet(m_hiZOutputSet).setDstBinding(0).setDescriptorCount(1U).setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(hiZOutputVertexBufferInfo);
-    m_renderContext.getDeviceHandle()->updateDescriptorSets(writeDescs, {});
+    RootBufferData rootData{};
+    rootData.vertexAddress = m_vertexBuffer->getDeviceAddress();
+    rootData.indexAddress = m_indexBuffer->getDeviceAddress();
+    rootData.clusterAddress = m_clusterBuffer->getDeviceAddress();
+    rootData.triangleCount = static_cast<uint32_t>(m_triangleCount);
+    rootData.clusterCount = static_cast<uint32_t>(m_clusterCount);
+    rootData.octreeNodeAddress = m_octreeNodeBuffer->getDeviceAddress();
+    rootData.octreeFaceAddress = m_octreeFaceBuffer->getDeviceAddress();
+    rootData.octreeNodeCount = static_cast<uint32_t>(m_octreeNodeCount);
+    for (auto &frame : m_frames)
+    {
+        rootData.renderExtent = glm::uvec2{frame.targetExtent.width, frame.targetExtent.height};
+
+        // create scanline required buffers
+        // the lbvh build sorts its morton codes with the same buffers, one pair per face
+        const size_t scanlineCapacity = std::max(static_cast<size_t>(1024 * (m_triangleCount / glm::length(box.getExtent()))), m_triangleCount);
+        frame.scanlineBuffer = m_renderContext.createBuffer(sizeof(ScanlineAttribute) * scanlineCapacity, vk::BufferUsageFlagBits::eStorageBuffer);
+        // a span crosses a few tiles on average
+        frame.scanlineTileEntries = m_renderContext.createBuffer(sizeof(uint32_t) * 4 * scanlineCapacity, vk::BufferUsageFlagBits::eStorageBuffer);
+        frame.scanlineSegmentOffsets = m_renderContext.createBuffer(sizeof(uint32_t) * scanlineCapacity, vk::BufferUsageFlagBits::eStorageBuffer);
+        for (auto &sortPairs : frame.scanlineSortPairs)
+            sortPairs = m_renderContext.createBuffer(sizeof(glm::uvec2) * scanlineCapacity, vk::BufferUsageFlagBits::eStorageBuffer);
+        frame.scanlineSortHistogram = m_renderContext.createBuffer(sizeof(uint32_t) * RADIX_SORT_BLOCK_SIZE * calWorkGroupCount(scanlineCapacity, RADIX_SORT_BLOCK_SIZE), vk::BufferUsageFlagBits::eStorageBuffer);
+
+        // create hi-z required buffers
+        // surviving faces keep their original indices, a quarter of copying their positions
+        frame.hiZOutputIndexBuffer = m_renderContext.createBuffer(sizeof(uint32_t) * indices.size(), vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+
+        // headers, then the work queue and the leaf queue, each of which can hold every node
+        frame.octreeQueues = m_renderContext.createBuffer(sizeof(glm::uvec4) * 2 + sizeof(uint32_t) * 2 * m_octreeNodeCount,
+                                                          vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+        // n - 1 internal nodes and n leaves, rebuilt every frame so that deforming geometry could be fed in
+        // clamped, so that a model without faces does not wrap the size around
+        frame.lbvhNodes = m_renderContext.createBuffer(sizeof(glm::vec4) * 3 * (std::max<size_t>(2 * m_triangleCount, 2ULL) - 1), vk::BufferUsageFlagBits::eShaderDeviceAddress);
+        frame.lbvhQueues = m_renderContext.createBuffer(sizeof(glm::uvec4) * 4 + sizeof(uint32_t) * 3 * m_triangleCount,
+                                                        vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+        // indirect dispatch size & face count, then one index per face
+        frame.hiZRejectedFaces = m_renderContext.createBuffer(sizeof(glm::uvec4) + sizeof(uint32_t) * m_triangleCount,
+                                                              vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+        frame.hiZVisibleClusters = m_renderContext.createBuffer(sizeof(glm::uvec4) + sizeof(uint32_t) * m_clusterCount,
+                                                                vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+
+        m_descriptorHeap.setStorageBuffer(frame.bufferHeapBase + SLOT_SCANLINE_BUFFER, *frame.scanlineBuffer);
+        m_descriptorHeap.setStorageBuffer(frame.bufferHeapBase + SLOT_SCANLINE_TILE_ENTRIES, *frame.scanlineTileEntries);
+        m_descriptorHeap.setStorageBuffer(frame.bufferHeapBase + SLOT_SCANLINE_SEGMENT_OFFSET, *frame.scanlineSegmentOffsets);
+        for (uint32_t i = 0; i < frame.scanlineSortPairs.size(); ++i)
+            m_descriptorHeap.setStorageBuffer(frame.bufferHeapBase + SLOT_SORT_PAIRS + i, *frame.scanlineSortPairs[i]);
+        m_descriptorHeap.setStorageBuffer(frame.bufferHeapBase + SLOT_SORT_HISTOGRAM, *frame.scanlineSortHistogram);
+
+        // GPU is idle here, so the root buffer can be rewritten in place
+        rootData.hiZOutputIndexAddress = frame.hiZOutputIndexBuffer->getDeviceAddress();
+        rootData.octreeQueueAddress = frame.octreeQueues->getDeviceAddress();
+        rootData.lbvhNodeAddress = frame.lbvhNodes->getDeviceAddress();
+        rootData.lbvhQueueAddress = frame.lbvhQueues->getDeviceAddress();
+        rootData.hiZRejectedAddress = frame.hiZRejectedFaces->getDeviceAddress();
+        rootData.hiZVisibleClusterAddress = frame.hiZVisibleClusters->getDeviceAddress();
+        memcpy(frame.rootBuffer->map(), &rootData, sizeof(RootBufferData));
+        frame.rootBuffer->unmap();
+        frame.graphDirty = true;
+    }
+    m_descriptorHeap.flush();
 }
 
-void ApplicationBase::recreateRenderTargets()
+void ApplicationBase::destroyRenderTargets(FrameResources &frame)
 {
-    if (m_zBuffer)
-        m_zBuffer.reset();
-    for (auto i = 0; i < m_zBufferMipViews.size(); ++i)
-        if (m_zBufferMipViews[i])
-            m_renderContext.getDeviceHandle()->destroy(m_zBufferMipViews[i], allocationCallbacks);
-    if (m_colorBuffer)
-        m_colorBuffer.reset();
-    if (m_colorBufferView)
-        m_renderContext.getDeviceHandle()->destroy(m_colorBufferView, allocationCallbacks);
-    if (m_scanlineBufferSpinlock)
-        m_scanlineBufferSpinlock.reset();
-    if (m_scanlineBufferSpinlockView)
-        m_renderContext.getDeviceHandle()->destroy(m_scanlineBufferSpinlockView, allocationCallbacks);
-    if (m_emptyBuffer)
-        m_emptyBuffer.reset();
-    if (m_emptyBufferView)
-        m_renderContext.getDeviceHandle()->destroy(m_emptyBufferView, allocationCallbacks);
-
-    m_pushConstants.mipLevelCount = static_cast<uint32_t>(std::floor(std::log2(std::max(m_mainWindow.Width, m_mainWindow.Height)))) + 1;
-    vk::ImageCreateInfo imageCreateInfo{};
-    imageCreateInfo.setImageType(vk::ImageType::e2D)
-        .setFormat(vk::Format::eR32Sfloat)
-        .setExtent(vk::Extent3D{m_size.width, m_size.height, 1U})
-        .setMipLevels(m_pushConstants.mipLevelCount)
-        .setArrayLayers(1U)
-        .setSamples(vk::SampleCountFlagBits::e1)
-        .setTiling(vk::ImageTiling::eOptimal)
-        .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst)
-        .setSharingMode(vk::SharingMode::eExclusive)
-        .setInitialLayout(vk::ImageLayout::eUndefined);
-    m_zBuffer = m_renderContext.createImage(imageCreateInfo);
-    imageCreateInfo.setFormat(vk::Format::eR8G8B8A8Unorm).setMipLevels(1U);
-    m_colorBuffer = m_renderContext.createImage(imageCreateInfo);
-    imageCreateInfo.setFormat(vk::Format::eR32Uint);
-    m_scanlineBufferSpinlock = m_renderContext.createImage(imageCreateInfo);
-    imageCreateInfo.setFormat(vk::Format::eR32Sfloat).setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst);
-    m_emptyBuffer = m_renderContext.createImage(imageCreateInfo);
-
-    m_zBufferMipViews.resize(m_pushConstants.mipLevelCount);
-    vk::ImageViewCreateInfo viewCreateInfo{};
-    viewCreateInfo.setImage(*m_zBuffer)
-        .setFormat(vk::Format::eR32Sfloat)
-        .setViewType(vk::ImageViewType::e2D)
-        .setComponents(vk::ComponentSwizzle::eIdentity)
-        .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS));
-    for (auto i = 0; i < m_pushConstants.mipLevelCount; ++i)
-    {
-        viewCreateInfo.subresourceRange.baseMipLevel = i;
-        m_zBufferMipViews[i] = m_renderContext.getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks);
+    // graphs import render targets
+    frame.prepassGraph.reset();
+    frame.computeGraph.reset();
+    frame.graphDirty = true;
+
+    // targets go back to the pool, where they wait for the window to come back to their size
+    for (auto *target : {&frame.zBufferTarget, &frame.colorBufferTarget, &frame.emptyBufferTarget})
+    {
+        m_targetPool.release(*target);
+        *target = ImagePool::invalidHandle;
     }
-    viewCreateInfo.setImage(*m_colorBuffer).setFormat(vk::Format::eR8G8B8A8Unorm).subresourceRange.baseMipLevel = 0;
-    m_colorBufferView = m_renderContext.getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks);
-    viewCreateInfo.setImage(*m_scanlineBufferSpinlock).setFormat(vk::Format::eR32Uint).subresourceRange.baseMipLevel = 0;
-    m_scanlineBufferSpinlockView = m_renderContext.getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks);
-    viewCreateInfo.setImage(*m_emptyBuffer).setFormat(vk::Format::eR32Sfloat).subresourceRange.baseMipLevel = 0;
-    m_emptyBufferView = m_renderContext.getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks);
-
-    // prepare for updating descriptors
-    std::vector<vk::DescriptorImageInfo> imageDescs{};
-    imageDescs.reserve(m_pushConstants.mipLevelCount);
-    for (auto i = 0; i < m_pushConstants.mipLevelCount; ++i)
-        imageDescs.emplace_back(vk::Sampler{}, m_zBufferMipViews[i], vk::ImageLayout::eGeneral);
-    std::vector<vk::WriteDescriptorSet> writeDescs{};
-    writeDescs.reserve(g_predefMaxMipLevel + 3);
-    for (auto i = 0; i < g_predefMaxMipLevel; ++i)
-        writeDescs.emplace_back(m_zBufferSet, 0, i, vk::DescriptorType::eStorageImage, i < m_pushConstants.mipLevelCount ? imageDescs[i] : imageDescs[m_pushConstants.mipLevelCount - 1]);
-    vk::DescriptorImageInfo spinlockInfo{vk::Sampler{}, m_scanlineBufferSpinlockView, vk::ImageLayout::eGeneral};
-    writeDescs.emplace_back(m_scanlineSet, 2, 0, vk::DescriptorType::eStorageImage, spinlockInfo);
-    vk::DescriptorImageInfo colorInfo{vk::Sampler{}, m_colorBufferView, vk::ImageLayout::eGeneral};
-    writeDescs.emplace_back(m_scanlineSet, 3, 0, vk::DescriptorType::eStorageImage, colorInfo);
-    vk::DescriptorImageInfo emptyInfo{vk::Sampler{}, m_emptyBufferView, vk::ImageLayout::eGeneral};
-    writeDescs.emplace_back(m_hiZOutputSet, 2, 0, vk::DescriptorType::eStorageImage, emptyInfo);
-    m_renderContext.getDeviceHandle()->updateDescriptorSets(writeDescs, {});
-
-    // init image layout
-    m_renderContext.getDeviceHandle()->resetCommandPool(m_internalTransferPool);
-    vk::CommandBufferAllocateInfo allocInfo{};
-    allocInfo.setCommandPool(m_internalTransferPool).setCommandBufferCount(1U).setLevel(vk::CommandBufferLevel::ePrimary);
-    auto transBuffer = m_renderContext.getDeviceHandle()->allocateCommandBuffers(allocInfo).front();
-    vk::CommandBufferBeginInfo beginInfo{};
-    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-    transBuffer.begin(beginInfo);
-
-    auto barrierBase = makeImageMemoryBarrier(*m_zBuffer, accessFlagsForImageLayout(vk::ImageLayout::eUndefined), accessFlagsForImageLayout(vk::ImageLayout::eGeneral),
-                                              vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral,
-                                              vk::ImageAspectFlagBits::eColor)
-                           .setSrcStageMask(pipelineStageForLayout(vk::ImageLayout::eUndefined))
-                           .setDstStageMask(pipelineStageForLayout(vk::ImageLayout::eGeneral));
-    std::vector<vk::ImageMemoryBarrier2> barriers;
-    barriers.reserve(g_predefMaxMipLevel + 3);
-    for (auto i = 0; i < g_predefMaxMipLevel; ++i)
-    {
-        barrierBase.subresourceRange.baseMipLevel = i < m_pushConstants.mipLevelCount ? i : m_pushConstants.mipLevelCount - 1;
-        barriers.emplace_back(barrierBase);
+    frame.zBuffer = vk::Image{};
+    frame.colorBuffer = vk::Image{};
+    frame.emptyBuffer = vk::Image{};
+    frame.targetExtent = vk::Extent2D{};
+}
+
+// called once the previous submission of this frame has finished, so its targets can usually be swapped without waiting for the device
+// temporal hi-z of the next frame is the exception, it reads this z-buffer & its heap slots as history and may still be pending
+// targets are allocated with a rounded up extent, resizing within it only changes the sub-rect shaders work on
+void ApplicationBase::updateRenderTargets(FrameResources &frame)
+{
+    m_pushConstants.mipLevelCount = std::min<uint32_t>(static_cast<uint32_t>(std::floor(std::log2(std::max(m_size.width, m_size.height)))) + 1, MAX_ZBUFFER_MIP_COUNT);
+    if (frame.targetExtent == m_size)
+        return;
+
+    const auto allocatedExtent = m_targetPool.roundExtent(vk::Extent3D{m_size.width, m_size.height, 1U});
+    if (frame.zBufferTarget == ImagePool::invalidHandle || m_targetPool.getExtent(frame.zBufferTarget) != allocatedExtent)
+    {
+        const auto &nextFrame = m_frames[(&frame - m_frames.data() + 1) % g_maxFramesInFlight];
+        if (nextFrame.historyZBuffer && nextFrame.historyZBuffer == frame.zBuffer)
+            m_renderContext.getDeviceHandle()->waitForFences(nextFrame.inFlightFence, VK_TRUE, UINT64_MAX);
+        destroyRenderTargets(frame);
+
+        vk::ImageCreateInfo imageCreateInfo{};
+        imageCreateInfo.setImageType(vk::ImageType::e2D)
+            .setExtent(allocatedExtent)
+            .setArrayLayers(1U)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined);
+
+        // mip chain follows the allocated extent, which never has fewer levels than the window size needs
+        const uint32_t mipLevelCount = std::min<uint32_t>(static_cast<uint32_t>(std::floor(std::log2(std::max(allocatedExtent.width, allocatedExtent.height)))) + 1, MAX_ZBUFFER_MIP_COUNT);
+        imageCreateInfo.setFormat(vk::Format::eR32Sfloat).setMipLevels(mipLevelCount);
+        frame.zBufferTarget = m_targetPool.acquire(imageCreateInfo);
+        imageCreateInfo.setFormat(vk::Format::eR8G8B8A8Unorm).setMipLevels(1U);
+        frame.colorBufferTarget = m_targetPool.acquire(imageCreateInfo);
+        imageCreateInfo.setFormat(vk::Format::eR32Sfloat);
+        frame.emptyBufferTarget = m_targetPool.acquire(imageCreateInfo);
+        frame.zBuffer = m_targetPool.getImage(frame.zBufferTarget);
+        frame.colorBuffer = m_targetPool.getImage(frame.colorBufferTarget);
+        frame.emptyBuffer = m_targetPool.getImage(frame.emptyBufferTarget);
+
+        // register into descriptor heap, mips beyond the allocated chain are left unbound
+        // contents are discarded by a transition from undefined layout before every use, so no layout init is needed here
+        for (auto i = 0U; i < mipLevelCount; ++i)
+            m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_ZBUFFER_MIP + i, m_targetPool.getImageView(frame.zBufferTarget, i));
+        m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_COLOR_BUFFER, m_targetPool.getImageView(frame.colorBufferTarget));
+        m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_EMPTY_BUFFER, m_targetPool.getImageView(frame.emptyBufferTarget));
+        m_descriptorHeap.flush();
     }
-    barrierBase.subresourceRange.baseMipLevel = 0;
-    barrierBase.setImage(*m_scanlineBufferSpinlock);
-    barriers.emplace_back(barrierBase);
-    barrierBase.setImage(*m_colorBuffer);
-    barriers.emplace_back(barrierBase);
-    barrierBase.setImage(*m_emptyBuffer);
-    barriers.emplace_back(barrierBase);
 
-    vk::DependencyInfo depInfo{};
-    depInfo.setImageMemoryBarriers(barriers);
-    transBuffer.pipelineBarrier2(depInfo);
-
-    transBuffer.end();
-    vk::SubmitInfo submitInfo{};
-    submitInfo.setCommandBuffers(transBuffer);
-    m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eTransfer, false)->queue_handle->submit(submitInfo, m_internalTransferFence);
-    m_renderContext.getDeviceHandle()->waitForFences(m_internalTransferFence, VK_TRUE, UINT64_MAX);
-    m_renderContext.getDeviceHandle()->resetFences(m_internalTransferFence);
+    // root buffer of this frame is idle as well
+    frame.targetExtent = m_size;
+    const glm::uvec2 renderExtent{m_size.width, m_size.height};
+    memcpy(static_cast<char *>(frame.rootBuffer->map()) + offsetof(RootBufferData, renderExtent), &renderExtent, sizeof(glm::uvec2));
+    frame.rootBuffer->unmap();
 }
 
-void ApplicationBase::createStaticResources()
+// clip planes follow the camera, and the 32 bits visibility buffer and painter's keys quantize depth over the model only,
+// so their few depth bits are not spent on empty space
+void ApplicationBase::updateRootData(FrameResources &frame)
 {
-    m_scanlineGlobalPropertyBuffer = m_renderContext.createBuffer(sizeof(glm::uvec4), vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer);
-    vk::DescriptorBufferInfo globalBufferInfo{*m_scanlineGlobalPropertyBuffer, 0ULL, sizeof(glm::uvec4)};
-
-    m_hiZIndirectRenderBuffer = m_renderContext.createBuffer(sizeof(glm::uvec4), vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer);
-    vk::DescriptorBufferInfo hiZIndirectBufferInfo{*m_hiZIndirectRenderBuffer, 0ULL, sizeof(glm::uvec4)};
-
-    vk::ImageCreateInfo imageCreateInfo{};
-    imageCreateInfo.setImageType(vk::ImageType::e3D)
-        .setFormat(vk::Format::eR32Uint)
-        .setExtent(vk::Extent3D{1ULL << (m_octreeLevelCount - 1), 1ULL << (m_octreeLevelCount - 1), 1ULL << (m_octreeLevelCount - 1)})
-        .setMipLevels(m_octreeLevelCount - m_octreeStartLevel)
-        .setArrayLayers(1U)
-        .setSamples(vk::SampleCountFlagBits::e1)
-        .setTiling(vk::ImageTiling::eOptimal)
-        .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst)
-        .setSharingMode(vk::SharingMode::eExclusive)
-        .setInitialLayout(vk::ImageLayout::eUndefined);
-    m_octreeLinkHeader = m_renderContext.createImage(imageCreateInfo);
-    m_octreeMarker = m_renderContext.createImage(imageCreateInfo);
-
-    m_octreeLinkHeaderMipViews.resize(imageCreateInfo.mipLevels);
-    m_octreeMarkerMipViews.resize(imageCreateInfo.mipLevels);
-    vk::ImageViewCreateInfo viewCreateInfo{};
-    viewCreateInfo.setImage(*m_octreeLinkHeader)
-        .setFormat(vk::Format::eR32Uint)
-        .setViewType(vk::ImageViewType::e3D)
-        .setComponents(vk::ComponentSwizzle::eIdentity)
-        .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS));
-    for (auto i = 0; i < imageCreateInfo.mipLevels; ++i)
-    {
-        viewCreateInfo.subresourceRange.baseMipLevel = i;
-        m_octreeLinkHeaderMipViews[i] = m_renderContext.getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks);
-    }
-    viewCreateInfo.setImage(*m_octreeMarker);
-    for (auto i = 0; i < imageCreateInfo.mipLevels; ++i)
+    const glm::vec2 clipPlanes = m_mainCamera.getClipPlanes();
+    std::array<float, 4> depthData{1.f, .0f, clipPlanes.x, clipPlanes.y};
+    for (auto i = 0U; i < 8U; ++i)
     {
-        viewCreateInfo.subresourceRange.baseMipLevel = i;
-        m_octreeMarkerMipViews[i] = m_renderContext.getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks);
+        const glm::vec4 corner{(i & 1U) ? m_bounding.maxPoint.x : m_bounding.minPoint.x,
+                               (i & 2U) ? m_bounding.maxPoint.y : m_bounding.minPoint.y,
+                               (i & 4U) ? m_bounding.maxPoint.z : m_bounding.minPoint.z, 1.f};
+        const glm::vec4 clip = m_pushConstants.matrixVP * corner;
+        // corners in front of the near plane clamp to it, depth is monotonic so the corners bound the whole model
+        const float z = (clip.w > .0f ? glm::clamp(clip.z / clip.w, .0f, 1.f) : .0f) * 2.f - 1.f;
+        // same linearization as linearizeDepth in the shaders
+        const float linearDepth = (2.f * clipPlanes.x) / (clipPlanes.y + clipPlanes.x - z * (clipPlanes.y - clipPlanes.x));
+        depthData[0] = std::min(depthData[0], linearDepth);
+        depthData[1] = std::max(depthData[1], linearDepth);
     }
 
-    m_faceIndicesOfOctree = m_renderContext.createBuffer(sizeof(glm::uvec2) * 256 * 1024 * 1024, vk::BufferUsageFlagBits::eStorageBuffer);
-    std::vector<glm::vec4> globalPropertyInitial = {{m_bounding.minPoint, 0}, {m_bounding.maxPoint, 0}};
-    vk::DescriptorBufferInfo faceIndicesInfo{*m_faceIndicesOfOctree, 0ULL, VK_WHOLE_SIZE};
-
-    std::vector<vk::WriteDescriptorSet> writeDescs(3);
-    writeDescs[0].setDstSet(m_scanlineSet).setDstBinding(1U).setDescriptorType(vk::DescriptorType::eStorageBuffer).setDescriptorCount(1U).setBufferInfo(globalBufferInfo);
-    writeDescs[1].setDstSet(m_hiZOutputSet).setDstBinding(1U).setDescriptorType(vk::DescriptorType::eStorageBuffer).setDescriptorCount(1U).setBufferInfo(hiZIndirectBufferInfo);
-    writeDescs[2].setDstSet(m_octreeSet).setDstBinding(2).setDescriptorCount(1U).setDescriptorType(vk::DescriptorType::eStorageBuffer).setBufferInfo(faceIndicesInfo);
-    m_renderContext.getDeviceHandle()->updateDescriptorSets(writeDescs, {});
-
-    std::vector<vk::DescriptorImageInfo> imageDescs{};
-    imageDescs.resize(imageCreateInfo.mipLevels * 2);
-    writeDescs.resize(imageCreateInfo.mipLevels * 2);
-    for (auto i = 0; i < imageCreateInfo.mipLevels; ++i)
-    {
-        imageDescs[i] = {vk::Sampler{}, m_octreeLinkHeaderMipViews[i], vk::ImageLayout::eGeneral};
-        imageDescs[i + imageCreateInfo.mipLevels] = {vk::Sampler{}, m_octreeMarkerMipViews[i], vk::ImageLayout::eGeneral};
-        writeDescs[i].setDstSet(m_octreeSet).setDstBinding(0).setDstArrayElement(i).setDescriptorCount(1).setDescriptorType(vk::DescriptorType::eStorageImage).setImageInfo(imageDescs[i]);
-        writeDescs[i + imageCreateInfo.mipLevels].setDstSet(m_octreeSet).setDstBinding(1).setDstArrayElement(i).setDescriptorCount(1).setDescriptorType(vk::DescriptorType::eStorageImage).setImageInfo(imageDescs[i + imageCreateInfo.mipLevels]);
+    // temporal hi-z reprojects the pyramid of the previous frame, whose graph was built against it
+    const auto &previousFrame = m_frames[(&frame - m_frames.data() + g_maxFramesInFlight - 1) % g_maxFramesInFlight];
+    const std::array<uint32_t, 2> history{previousFrame.imageHeapBase, frame.historyZBuffer ? 1U : 0U};
+    frame.matrixVP = m_pushConstants.matrixVP;
+
+    // root buffer of this frame is idle once its fence has been waited
+    static_assert(offsetof(RootBufferData, farPlane) - offsetof(RootBufferData, depthRangeMin) == 3 * sizeof(float));
+    auto *rootData = static_cast<char *>(frame.rootBuffer->map());
+    memcpy(rootData + offsetof(RootBufferData, depthRangeMin), depthData.data(), sizeof(depthData));
+    memcpy(rootData + offsetof(RootBufferData, historyImageHeapBase), history.data(), sizeof(history));
+    memcpy(rootData + offsetof(RootBufferData, historyMatrixVP), &previousFrame.matrixVP, sizeof(glm::mat4));
+    const glm::vec4 cameraPosition{m_mainCamera.getLookat()[0], 1.f};
+    memcpy(rootData + offsetof(RootBufferData, cameraPosition), &cameraPosition, sizeof(glm::vec4));
+    frame.rootBuffer->unmap();
+}
+
+// z-buffer of the previous frame when its pyramid was built by temporal hi-z at the same size, the previous frame is submitted right before
+vk::Image ApplicationBase::getTemporalHistory(const FrameResources &frame) const
+{
+    const auto &previousFrame = m_frames[(&frame - m_frames.data() + g_maxFramesInFlight - 1) % g_maxFramesInFlight];
+    if (previousFrame.graphMode != eRenderingMode::RENDERING_MODE_TEMPORAL_HI_ZBUFFER || previousFrame.targetExtent != frame.targetExtent)
+        return {};
+    return previousFrame.zBuffer;
+}
+
+void ApplicationBase::createStaticResources()
+{
+    for (auto &frame : m_frames)
+    {
+        frame.scanlineGlobalPropertyBuffer = m_renderContext.createBuffer(sizeof(ScanlineGlobalProperty), vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst);
+        m_descriptorHeap.setStorageBuffer(frame.bufferHeapBase + SLOT_SCANLINE_GLOBAL_PROPERTY, *frame.scanlineGlobalPropertyBuffer, 0ULL, sizeof(ScanlineGlobalProperty));
+
+        frame.hiZIndirectRenderBuffer = m_renderContext.createBuffer(sizeof(vk::DrawIndexedIndirectCommand), vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst);
+        m_descriptorHeap.setStorageBuffer(frame.bufferHeapBase + SLOT_HIZ_INDIRECT, *frame.hiZIndirectRenderBuffer, 0ULL, sizeof(vk::DrawIndexedIndirectCommand));
     }
-    m_renderContext.getDeviceHandle()->updateDescriptorSets(writeDescs, {});
-
-    // init image layout
-    m_renderContext.getDeviceHandle()->resetCommandPool(m_internalTransferPool);
-    vk::CommandBufferAllocateInfo allocInfo{};
-    allocInfo.setCommandPool(m_internalTransferPool).setCommandBufferCount(1U).setLevel(vk::CommandBufferLevel::ePrimary);
-    auto transBuffer = m_renderContext.getDeviceHandle()->allocateCommandBuffers(allocInfo).front();
-    vk::CommandBufferBeginInfo beginInfo{};
-    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-    transBuffer.begin(beginInfo);
-
-    cmdBarrierImageLayout(transBuffer, *m_octreeLinkHeader, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
-    cmdBarrierImageLayout(transBuffer, *m_octreeMarker, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
-
-    transBuffer.end();
-    vk::SubmitInfo submitInfo{};
-    submitInfo.setCommandBuffers(transBuffer);
-    m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eTransfer, false)->queue_handle->submit(submitInfo, m_internalTransferFence);
-    m_renderContext.getDeviceHandle()->waitForFences(m_internalTransferFence, VK_TRUE, UINT64_MAX);
-    m_renderContext.getDeviceHandle()->resetFences(m_internalTransferFence);
+    m_descriptorHeap.flush();
 }
 
-void ApplicationBase::createRenderer()
+void ApplicationBase::createRenderer(const std::filesystem::path &modelPath)
 {
-    std::vector<vk::DescriptorPoolSize> poolSizes;
-    poolSizes.emplace_back(vk::DescriptorType::eStorageImage, 16U);
-    poolSizes.emplace_back(vk::DescriptorType::eStorageBuffer, 16U);
-    vk::DescriptorPoolCreateInfo descPoolCreateInfo;
-    descPoolCreateInfo.setMaxSets(8U)
-        .setPoolSizes(poolSizes);
-    m_descPool = m_renderContext.getDeviceHandle()->createDescriptorPool(descPoolCreateInfo, allocationCallbacks);
-
-    std::vector<vk::DescriptorSetLayoutBinding> setLayoutBindings{};
-    vk::DescriptorSetLayoutCreateInfo setLayoutCreateInfo{};
-    setLayoutBindings.emplace_back(0, vk::DescriptorType::eStorageImage, g_predefMaxMipLevel, vk::ShaderStageFlagBits::eAll);
-    setLayoutCreateInfo.setBindings(setLayoutBindings);
-    m_zBufferSetLayout = m_renderContext.getDeviceHandle()->createDescriptorSetLayout(setLayoutCreateInfo, allocationCallbacks);
-    setLayoutBindings.clear();
-    setLayoutBindings.emplace_back(0, vk::DescriptorType::eStorageBuffer, 1U, vk::ShaderStageFlagBits::eAll);
-    setLayoutBindings.emplace_back(1, vk::DescriptorType::eStorageBuffer, 1U, vk::ShaderStageFlagBits::eAll);
-    setLayoutCreateInfo.setBindings(setLayoutBindings);
-    m_geometrySetLayout = m_renderContext.getDeviceHandle()->createDescriptorSetLayout(setLayoutCreateInfo, allocationCallbacks);
-    setLayoutBindings.clear();
-    setLayoutBindings.emplace_back(0, vk::DescriptorType::eStorageBuffer, 1U, vk::ShaderStageFlagBits::eAll);
-    setLayoutBindings.emplace_back(1, vk::DescriptorType::eStorageBuffer, 1U, vk::ShaderStageFlagBits::eAll);
-    setLayoutBindings.emplace_back(2, vk::DescriptorType::eStorageImage, 1U, vk::ShaderStageFlagBits::eAll);
-    setLayoutBindings.emplace_back(3, vk::DescriptorType::eStorageImage, 1U, vk::ShaderStageFlagBits::eAll);
-    setLayoutCreateInfo.setBindings(setLayoutBindings);
-    m_scanlineSetLayout = m_renderContext.getDeviceHandle()->createDescriptorSetLayout(setLayoutCreateInfo, allocationCallbacks);
-    setLayoutBindings.clear();
-    setLayoutBindings.emplace_back(0, vk::DescriptorType::eStorageBuffer, 1U, vk::ShaderStageFlagBits::eAll);
-    setLayoutBindings.emplace_back(1, vk::DescriptorType::eStorageBuffer, 1U, vk::ShaderStageFlagBits::eAll);
-    setLayoutBindings.emplace_back(2, vk::DescriptorType::eStorageImage, 1U, vk::ShaderStageFlagBits::eAll);
-    m_hiZOutputSetLayout = m_renderContext.getDeviceHandle()->createDescriptorSetLayout(setLayoutCreateInfo, allocationCallbacks);
-    setLayoutBindings.clear();
-    setLayoutBindings.emplace_back(0, vk::DescriptorType::eStorageImage, m_octreeLevelCount - m_octreeStartLevel, vk::ShaderStageFlagBits::eAll);
-    setLayoutBindings.emplace_back(1, vk::DescriptorType::eStorageImage, m_octreeLevelCount - m_octreeStartLevel, vk::ShaderStageFlagBits::eAll);
-    setLayoutBindings.emplace_back(2, vk::DescriptorType::eStorageBuffer, 1U, vk::ShaderStageFlagBits::eAll);
-    m_octreeSetLayout = m_renderContext.getDeviceHandle()->createDescriptorSetLayout(setLayoutCreateInfo, allocationCallbacks);
-
-    std::vector setLayoutContainer = {m_zBufferSetLayout, m_geometrySetLayout, m_scanlineSetLayout, m_hiZOutputSetLayout, m_octreeSetLayout};
-    vk::DescriptorSetAllocateInfo setAllocInfo{};
-    setAllocInfo.setDescriptorPool(m_descPool).setSetLayouts(setLayoutContainer);
-    auto allocatedSets = m_renderContext.getDeviceHandle()->allocateDescriptorSets(setAllocInfo);
-    m_zBufferSet = allocatedSets[0];
-    m_geometrySet = allocatedSets[1];
-    m_scanlineSet = allocatedSets[2];
-    m_hiZOutputSet = allocatedSets[3];
-    m_octreeSet = allocatedSets[4];
+    // every frame owns a fixed slot range of the heap, see shaderInterface.h
+    m_descriptorHeap.init(m_renderContext.getDeviceHandle(), HEAP_MAX_STORAGE_IMAGE_COUNT, HEAP_MAX_STORAGE_BUFFER_COUNT);
+    m_targetPool.init(m_renderContext);
+    for (auto i = 0U; i < g_maxFramesInFlight; ++i)
+    {
+        m_frames[i].imageHeapBase = i * IMAGE_SLOTS_PER_FRAME;
+        m_frames[i].bufferHeapBase = i * BUFFER_SLOTS_PER_FRAME;
+        m_frames[i].rootBuffer = m_renderContext.createBuffer(sizeof(RootBufferData), vk::BufferUsageFlagBits::eShaderDeviceAddress,
+                                                              vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    }
 
     vk::CommandPoolCreateInfo poolCreateInfo{};
     poolCreateInfo.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
@@ -315,60 +307,129 @@ void ApplicationBase::createRenderer()
     vk::FenceCreateInfo fenceCreateInfo{};
     m_internalTransferFence = m_renderContext.getDeviceHandle()->createFence(fenceCreateInfo, allocationCallbacks);
 
-    reloadModel("./resources/models/cgaxis_107_11_cafe_stall_obj.obj");
+    // compute falls back to graphics queue when there is no dedicated family
+    m_graphicsQueueFamily = m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eGraphics)->queue_family_index;
+    m_computeQueueFamily = m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eCompute, false)->queue_family_index;
+    m_computeTimestampSupported = m_renderContext.getAdapterHandle()->getQueueFamilyProperties()[m_computeQueueFamily].timestampValidBits > 0;
+
+    // optional features, modes depending on missing ones are disabled or fall back
+    const auto adapterFeatures = m_renderContext.getAdapterHandle()->getFeatures2<vk::PhysicalDeviceFeatures2,
+                                                                                  vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT,
+                                                                                  vk::PhysicalDeviceShaderImageAtomicInt64FeaturesEXT>();
+    m_interlockSupported = m_renderContext.isDeviceExtensionEnabled(VK_EXT_FRAGMENT_SHADER_INTERLOCK_EXTENSION_NAME) &&
+                           adapterFeatures.get<vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT>().fragmentShaderPixelInterlock;
+    m_imageInt64AtomicsSupported = m_renderContext.isDeviceExtensionEnabled(VK_EXT_SHADER_IMAGE_ATOMIC_INT64_EXTENSION_NAME) &&
+                                   adapterFeatures.get<vk::PhysicalDeviceFeatures2>().features.shaderInt64 &&
+                                   adapterFeatures.get<vk::PhysicalDeviceShaderImageAtomicInt64FeaturesEXT>().shaderImageInt64Atomics &&
+                                   (m_renderContext.getAdapterHandle()->getFormatProperties(vk::Format::eR64Uint).optimalTilingFeatures & vk::FormatFeatureFlagBits::eStorageImageAtomic);
+    if (!m_interlockSupported)
+        spdlog::warn("Fragment shader pixel interlock is not supported, modes based on it are disabled.");
+    if (!m_imageInt64AtomicsSupported)
+        spdlog::info("64 bits image atomics are not supported, visibility buffer falls back to 32 bits packing.");
+    // compute allocations are aggregated per subgroup, which every desktop driver supports but core vulkan does not require
+    const auto subgroupProperties = m_renderContext.getAdapterHandle()->getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceSubgroupProperties>().get<vk::PhysicalDeviceSubgroupProperties>();
+    const auto requiredSubgroupOperations = vk::SubgroupFeatureFlagBits::eBasic | vk::SubgroupFeatureFlagBits::eArithmetic | vk::SubgroupFeatureFlagBits::eBallot | vk::SubgroupFeatureFlagBits::eClustered;
+    if (!(subgroupProperties.supportedStages & vk::ShaderStageFlagBits::eCompute) || (subgroupProperties.supportedOperations & requiredSubgroupOperations) != requiredSubgroupOperations)
+        spdlog::error("Subgroup arithmetic, ballot & clustered operations are not supported in compute shaders, compute based modes will fail.");
+    if (!isModeSupported(m_renderingMode))
+        m_renderingMode = eRenderingMode::RENDERING_MODE_DEFAULT_WIREFRAME;
+
+    // per frame submission objects, fences start signaled so that the first wait on each frame returns immediately
+    vk::CommandPoolCreateInfo framePoolCreateInfo{};
+    framePoolCreateInfo.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+    fenceCreateInfo.setFlags(vk::FenceCreateFlagBits::eSignaled);
+    vk::SemaphoreCreateInfo semaphoreCreateInfo{};
+    auto createRecordingContext = [&](RecordingContext &context, uint32_t queueFamily, vk::CommandBufferLevel level)
+    {
+        framePoolCreateInfo.setQueueFamilyIndex(queueFamily);
+        context.pool = m_renderContext.getDeviceHandle()->createCommandPool(framePoolCreateInfo, allocationCallbacks);
+        vk::CommandBufferAllocateInfo cmdAllocInfo{};
+        cmdAllocInfo.setCommandPool(context.pool)
+            .setLevel(level)
+            .setCommandBufferCount(1U);
+        context.cmdBuffer = m_renderContext.getDeviceHandle()->allocateCommandBuffers(cmdAllocInfo).front();
+    };
+    for (auto &frame : m_frames)
+    {
+        createRecordingContext(frame.prepass, m_graphicsQueueFamily, vk::CommandBufferLevel::ePrimary);
+        createRecordingContext(frame.compute, m_computeQueueFamily, vk::CommandBufferLevel::ePrimary);
+        createRecordingContext(frame.post, m_graphicsQueueFamily, vk::CommandBufferLevel::ePrimary);
+        createRecordingContext(frame.scene, m_graphicsQueueFamily, vk::CommandBufferLevel::eSecondary);
+        createRecordingContext(frame.ui, m_graphicsQueueFamily, vk::CommandBufferLevel::eSecondary);
+        frame.prepassFinishedSemaphore = m_renderContext.getDeviceHandle()->createSemaphore(semaphoreCreateInfo, allocationCallbacks);
+        frame.computeFinishedSemaphore = m_renderContext.getDeviceHandle()->createSemaphore(semaphoreCreateInfo, allocationCallbacks);
+        frame.inFlightFence = m_renderContext.getDeviceHandle()->createFence(fenceCreateInfo, allocationCallbacks);
+        frame.profiler.init(m_renderContext.getDeviceHandle(), *m_renderContext.getAdapterHandle());
+    }
+
+    reloadModel(modelPath);
     // reloadModel("./resources/models/6.837.obj");
     // reloadModel("./resources/models/bunny_1k.obj");
-    recreateRenderTargets();
     createStaticResources();
 
-    vk::PushConstantRange pushConstants = {vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0ULL, sizeof(PushConstants)};
+    // one layout for every pipeline, so the heap and push constants stay bound across pipeline switches
+    vk::PushConstantRange pushConstants = {vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute, 0ULL, sizeof(PushConstants)};
+    vk::DescriptorSetLayout heapLayout = m_descriptorHeap.getLayout();
     vk::PipelineLayoutCreateInfo layoutCreateInfo{};
-    setLayoutContainer = {m_geometrySetLayout, m_zBufferSetLayout};
-    layoutCreateInfo.setSetLayouts(setLayoutContainer)
+    layoutCreateInfo.setSetLayouts(heapLayout)
         .setPushConstantRanges(pushConstants);
-    m_naiveZBufferPipelineLayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
-    layoutCreateInfo.setSetLayouts(m_zBufferSetLayout);
-    m_zPrepassPipelinelayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
-    pushConstants.setStageFlags(vk::ShaderStageFlagBits::eCompute);
-    setLayoutContainer = {m_geometrySetLayout, m_scanlineSetLayout, m_zBufferSetLayout};
-    layoutCreateInfo.setSetLayouts(setLayoutContainer)
-        .setPushConstantRanges(pushConstants);
-    m_scanlineZBufferPipelineLayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
-    layoutCreateInfo.setSetLayouts(m_zBufferSetLayout);
-    m_zBufferMipMappingPipelineLayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
-    setLayoutContainer = {m_geometrySetLayout, m_octreeSetLayout, m_zBufferSetLayout};
-    layoutCreateInfo.setSetLayouts(setLayoutContainer);
-    m_octreeInitPipelineLayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
-    setLayoutContainer = {m_geometrySetLayout, m_zBufferSetLayout, m_hiZOutputSetLayout, m_octreeSetLayout};
-    pushConstants.setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute);
-    layoutCreateInfo.setSetLayouts(setLayoutContainer)
-        .setPushConstantRanges(pushConstants);
-    m_hiZBufferOutputPipelineLayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
-    pushConstants.setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment);
-    layoutCreateInfo.setSetLayouts({});
-    m_defaultPipelineLayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
-    layoutCreateInfo.setSetLayouts(m_scanlineSetLayout)
-        .setPushConstantRanges({});
-    m_blitPipelineLayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
-
-    ComputePipelineHelper computeHelper(m_renderContext.getDeviceHandle(), m_scanlineZBufferPipelineLayout);
+    m_pipelineLayout = m_renderContext.getDeviceHandle()->createPipelineLayout(layoutCreateInfo, allocationCallbacks);
+
+    ComputePipelineHelper computeHelper(m_renderContext.getDeviceHandle(), m_pipelineLayout);
     computeHelper.setShader(loadFile("./resources/shaders/compiled/scanlineZBufferInit.comp.spv", true));
     m_scanlineZBufferInitPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
     computeHelper.setShader(loadFile("./resources/shaders/compiled/scanlineZBufferWork.comp.spv", true));
     m_scanlineZBufferWorkPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
-    computeHelper.setLayout(m_zBufferMipMappingPipelineLayout);
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/scanlineSegmentScan.comp.spv", true));
+    m_scanlineSegmentScanPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/radixSortHistogram.comp.spv", true));
+    m_radixSortHistogramPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/radixSortScan.comp.spv", true));
+    m_radixSortScanPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/radixSortScatter.comp.spv", true));
+    m_radixSortScatterPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/scanlinePainterFill.comp.spv", true));
+    m_scanlinePainterFillPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/scanlineTileCount.comp.spv", true));
+    m_scanlineTileCountPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/scanlineTileScan.comp.spv", true));
+    m_scanlineTileScanPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/scanlineTileScatter.comp.spv", true));
+    m_scanlineTileScatterPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/scanlineTileResolve.comp.spv", true));
+    m_scanlineTileResolvePipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile(m_imageInt64AtomicsSupported ? "./resources/shaders/compiled/scanlinePackedWork64.comp.spv" : "./resources/shaders/compiled/scanlinePackedWork32.comp.spv", true));
+    m_scanlinePackedWorkPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile(m_imageInt64AtomicsSupported ? "./resources/shaders/compiled/scanlinePackedResolve64.comp.spv" : "./resources/shaders/compiled/scanlinePackedResolve32.comp.spv", true));
+    m_scanlinePackedResolvePipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile(m_imageInt64AtomicsSupported ? "./resources/shaders/compiled/hybridRaster64.comp.spv" : "./resources/shaders/compiled/hybridRaster32.comp.spv", true));
+    m_hybridRasterPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
     computeHelper.setShader(loadFile("./resources/shaders/compiled/zBufferMipMapper.comp.spv", true));
     m_zBufferMipMappingPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
-    computeHelper.setLayout(m_octreeInitPipelineLayout);
-    computeHelper.setShader(loadFile("./resources/shaders/compiled/octreeInit.comp.spv", true));
-    m_octreeInitPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
-    computeHelper.setLayout(m_hiZBufferOutputPipelineLayout);
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/hiZClusterCulling.comp.spv", true));
+    m_hiZClusterCullingPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
     computeHelper.setShader(loadFile("./resources/shaders/compiled/naiveHiZBufferWork.comp.spv", true));
     m_naiveHiZBufferWorkPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
     computeHelper.setShader(loadFile("./resources/shaders/compiled/optimHiZBufferWork.comp.spv", true));
     m_optimHiZBufferWorkPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/octreeLeafCulling.comp.spv", true));
+    m_octreeLeafCullingPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/lbvhMorton.comp.spv", true));
+    m_lbvhMortonPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/lbvhHierarchy.comp.spv", true));
+    m_lbvhHierarchyPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/lbvhRefit.comp.spv", true));
+    m_lbvhRefitPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/lbvhFrontier.comp.spv", true));
+    m_lbvhFrontierPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/lbvhSubtree.comp.spv", true));
+    m_lbvhSubtreePipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/temporalHiZCulling.comp.spv", true));
+    m_temporalHiZCullingPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    computeHelper.setShader(loadFile("./resources/shaders/compiled/temporalHiZRecheck.comp.spv", true));
+    m_temporalHiZRecheckPipeline = computeHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
 
-    GraphicsPipelineHelper graphicsHelper(m_renderContext.getDeviceHandle(), m_defaultPipelineLayout, m_mainWindow.RenderPass);
+    GraphicsPipelineHelper graphicsHelper(m_renderContext.getDeviceHandle(), m_pipelineLayout, m_mainWindow.RenderPass);
     graphicsHelper.addShader(loadFile("./resources/shaders/compiled/raster.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
     graphicsHelper.addShader(loadFile("./resources/shaders/compiled/raster.frag.spv", true), vk::ShaderStageFlagBits::eFragment);
     graphicsHelper.addBindingDescription(graphicsHelper.makeVertexInputBinding(0, sizeof(glm::vec4)));
@@ -376,33 +437,51 @@ void ApplicationBase::createRenderer()
     graphicsHelper.rasterizationState.setPolygonMode(vk::PolygonMode::eLine);
     m_defaultFramePipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
 
-    graphicsHelper.setLayout(m_naiveZBufferPipelineLayout);
-    graphicsHelper.clearShaders();
-    graphicsHelper.addShader(loadFile("./resources/shaders/compiled/raster.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
-    graphicsHelper.addShader(loadFile("./resources/shaders/compiled/naiveZBuffer.frag.spv", true), vk::ShaderStageFlagBits::eFragment);
     graphicsHelper.rasterizationState.setPolygonMode(vk::PolygonMode::eFill);
     graphicsHelper.depthStencilState.setDepthTestEnable(VK_FALSE)
         .setDepthWriteEnable(VK_FALSE)
         .setStencilTestEnable(VK_FALSE);
-    m_naiveZBufferPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    // shader modules declaring the interlock capability must not reach devices without it
+    if (m_interlockSupported)
+    {
+        graphicsHelper.clearShaders();
+        graphicsHelper.addShader(loadFile("./resources/shaders/compiled/raster.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
+        graphicsHelper.addShader(loadFile("./resources/shaders/compiled/naiveZBuffer.frag.spv", true), vk::ShaderStageFlagBits::eFragment);
+        m_naiveZBufferPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
 
-    graphicsHelper.setLayout(m_hiZBufferOutputPipelineLayout);
-    graphicsHelper.clearShaders();
-    graphicsHelper.addShader(loadFile("./resources/shaders/compiled/raster.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
-    graphicsHelper.addShader(loadFile("./resources/shaders/compiled/hiZPostRender.frag.spv", true), vk::ShaderStageFlagBits::eFragment);
-    m_hiZBufferPostRenderPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+        graphicsHelper.clearShaders();
+        graphicsHelper.addShader(loadFile("./resources/shaders/compiled/raster.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
+        graphicsHelper.addShader(loadFile("./resources/shaders/compiled/hiZPostRender.frag.spv", true), vk::ShaderStageFlagBits::eFragment);
+        m_hiZBufferPostRenderPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    }
 
+    // passes without any attachment, results are written into storage images only
     vk::PipelineRenderingCreateInfo renderingInfo{};
-    graphicsHelper.setLayout(m_zPrepassPipelinelayout);
     graphicsHelper.setRenderPass({});
+    graphicsHelper.setPipelineRenderingCreateInfo(renderingInfo);
+    graphicsHelper.clearBlendAttachmentStates();
+    if (m_interlockSupported)
+    {
+        graphicsHelper.clearShaders();
+        graphicsHelper.addShader(loadFile("./resources/shaders/compiled/zPrepass.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
+        graphicsHelper.addShader(loadFile("./resources/shaders/compiled/zPrepass.frag.spv", true), vk::ShaderStageFlagBits::eFragment);
+        m_zPrepassPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    }
+
     graphicsHelper.clearShaders();
     graphicsHelper.addShader(loadFile("./resources/shaders/compiled/zPrepass.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
-    graphicsHelper.addShader(loadFile("./resources/shaders/compiled/zPrepass.frag.spv", true), vk::ShaderStageFlagBits::eFragment);
-    graphicsHelper.setPipelineRenderingCreateInfo(renderingInfo);
-    m_zPrepassPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+    graphicsHelper.addShader(loadFile(m_imageInt64AtomicsSupported ? "./resources/shaders/compiled/visibilityBuffer64.frag.spv" : "./resources/shaders/compiled/visibilityBuffer32.frag.spv", true),
+                             vk::ShaderStageFlagBits::eFragment);
+    m_visibilityRasterPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
+
+    graphicsHelper.clearShaders();
+    graphicsHelper.addShader(loadFile("./resources/shaders/compiled/zPrepass.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
+    graphicsHelper.addShader(loadFile(m_imageInt64AtomicsSupported ? "./resources/shaders/compiled/visibilityHybrid64.frag.spv" : "./resources/shaders/compiled/visibilityHybrid32.frag.spv", true),
+                             vk::ShaderStageFlagBits::eFragment);
+    m_visibilityHybridRasterPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
 
-    graphicsHelper.setLayout(m_blitPipelineLayout);
     graphicsHelper.setRenderPass(m_mainWindow.RenderPass);
+    graphicsHelper.addBlendAttachmentState(GraphicsPipelineHelper::makePipelineColorBlendAttachmentState());
     graphicsHelper.clearShaders();
     graphicsHelper.clearBindingDescriptions();
     graphicsHelper.clearAttributeDescriptions();
@@ -411,19 +490,28 @@ void ApplicationBase::createRenderer()
     graphicsHelper.rasterizationState.setCullMode(vk::CullModeFlagBits::eNone);
     m_blitPipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
 
-    m_shaderRWBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eAllGraphics)
-        .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eAllGraphics)
-        .setSrcAccessMask(vk::AccessFlagBits2::eShaderWrite)
-        .setDstAccessMask(vk::AccessFlagBits2::eShaderRead);
+    graphicsHelper.clearShaders();
+    graphicsHelper.addShader(loadFile("./resources/shaders/compiled/screenQuad.vert.spv", true), vk::ShaderStageFlagBits::eVertex);
+    graphicsHelper.addShader(loadFile(m_imageInt64AtomicsSupported ? "./resources/shaders/compiled/visibilityResolve64.frag.spv" : "./resources/shaders/compiled/visibilityResolve32.frag.spv", true),
+                             vk::ShaderStageFlagBits::eFragment);
+    m_visibilityResolvePipeline = graphicsHelper.createPipeline(*m_renderContext.getPipelineCacheHandle());
 
-    m_imageClearBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
-        .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eAllGraphics)
+    // barriers of prepass & compute work are derived by the frame graphs, see buildFrameGraphs()
+    m_imageClearBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eClear)
+        .setDstStageMask(vk::PipelineStageFlagBits2::eFragmentShader)
         .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
-        .setDstAccessMask(vk::AccessFlagBits2::eShaderRead);
+        .setDstAccessMask(vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
 
     m_zPrepassRenderingInfo.setLayerCount(1U);
 }
 
+// heap set and push constants are compatible with every pipeline, bind once per command buffer
+void ApplicationBase::bindDescriptorHeap(vk::CommandBuffer &cmdBuffer, vk::PipelineBindPoint bindPoint)
+{
+    cmdBuffer.bindDescriptorSets(bindPoint, m_pipelineLayout, 0, m_descriptorHeap.getSet(), {});
+    cmdBuffer.pushConstants(m_pipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute, 0ULL, sizeof(PushConstants), &m_pushConstants);
+}
+
 void ApplicationBase::updateRenderData()
 {
     auto matrixView = m_mainCamera.getViewMatrix();
@@ -433,47 +521,54 @@ void ApplicationBase::updateRenderData()
     m_pushConstants.maxBoundWorld = {m_bounding.maxPoint, 1};
 }
 
-void ApplicationBase::clearZBuffer(vk::CommandBuffer &cmdBuffer)
+// contents of last frame are discarded by transitioning from undefined layout
+// so images can be taken over by any queue family without an ownership transfer
+static void clearImages(vk::CommandBuffer &cmdBuffer, const std::vector<std::pair<vk::Image, vk::ClearColorValue>> &images, const vk::MemoryBarrier2 &clearBarrier)
 {
-    vk::ClearColorValue clearVal{0x7F7FFFFF, 0, 0, 0};
-    cmdBuffer.clearColorImage(*m_zBuffer, vk::ImageLayout::eGeneral, clearVal, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
-    clearVal = {0, 0, 0, 0};
-    if (m_renderingMode == eRenderingMode::RENDERING_MODE_SCANLINE_ZBUFFER)
-    {
-        cmdBuffer.clearColorImage(*m_scanlineBufferSpinlock, vk::ImageLayout::eGeneral, clearVal, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
-        cmdBuffer.clearColorImage(*m_colorBuffer, vk::ImageLayout::eGeneral, clearVal, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
-    }
-    clearVal = {0x7F7FFFFF, 0, 0, 0};
-    if (m_renderingMode >= eRenderingMode::RENDERING_MODE_NAIVE_HI_ZBUFFER)
-        cmdBuffer.clearColorImage(*m_emptyBuffer, vk::ImageLayout::eGeneral, clearVal, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
-    if (m_renderingMode == eRenderingMode::RENDERING_MODE_OPTIM_HI_ZBUFFER)
-    {
-        clearVal = {0xFFFFFFFF, 0ULL, 0ULL, 0ULL};
-        cmdBuffer.clearColorImage(*m_octreeLinkHeader, vk::ImageLayout::eGeneral, clearVal, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
-        clearVal = {0, 0, 0, 0};
-        cmdBuffer.clearColorImage(*m_octreeMarker, vk::ImageLayout::eGeneral, clearVal, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
-    }
-    cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, m_imageClearBarrier});
+    std::vector<vk::ImageMemoryBarrier2> barriers{};
+    barriers.reserve(images.size());
+    for (const auto &[image, _] : images)
+        barriers.emplace_back(makeImageMemoryBarrier(image, {}, vk::AccessFlagBits2::eTransferWrite,
+                                                     vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral,
+                                                     vk::ImageAspectFlagBits::eColor)
+                                  .setSrcStageMask(vk::PipelineStageFlagBits2::eTopOfPipe)
+                                  .setDstStageMask(vk::PipelineStageFlagBits2::eClear));
+    vk::DependencyInfo depInfo{};
+    depInfo.setImageMemoryBarriers(barriers);
+    cmdBuffer.pipelineBarrier2(depInfo);
+
+    for (const auto &[image, clearVal] : images)
+        cmdBuffer.clearColorImage(image, vk::ImageLayout::eGeneral, clearVal, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+    cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, clearBarrier});
 }
 
-void ApplicationBase::render(vk::CommandBuffer &cmdBuffer)
+// only naive z-buffer clears right before drawing, other modes clear inside their graphs
+void ApplicationBase::clearZBuffer(vk::CommandBuffer &cmdBuffer, FrameResources &frame)
 {
-    // for all piplines using Z-Buffer, we need to call clear first(for all mip levels)
-    if (m_renderingMode >= eRenderingMode::RENDERING_MODE_NAIVE_ZBUFFER)
-        clearZBuffer(cmdBuffer);
-
-    if (m_renderingMode == eRenderingMode::RENDERING_MODE_SCANLINE_ZBUFFER)
-    {
-        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineZBufferInitPipeline);
-        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_scanlineZBufferPipelineLayout, 0, {m_geometrySet, m_scanlineSet, m_zBufferSet}, {});
-        cmdBuffer.pushConstants(m_scanlineZBufferPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0ULL, sizeof(PushConstants), &m_pushConstants);
-        cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount, 1024), 1, 1);
-        cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, m_shaderRWBarrier});
-        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineZBufferWorkPipeline);
-        cmdBuffer.dispatchIndirect(*m_scanlineGlobalPropertyBuffer, 0ULL);
-        cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, m_shaderRWBarrier});
-    }
-    else if (m_renderingMode >= eRenderingMode::RENDERING_MODE_NAIVE_HI_ZBUFFER)
+    if (m_renderingMode == eRenderingMode::RENDERING_MODE_NAIVE_ZBUFFER)
+        clearImages(cmdBuffer, {{frame.zBuffer, vk::ClearColorValue{0x7F7FFFFF, 0, 0, 0}}}, m_imageClearBarrier);
+}
+
+// passes of current rendering mode declare what they touch, barriers in between are derived by the graphs
+// queue family ownership transfers stay explicit around graph execution, see renderPrepass() and render()
+void ApplicationBase::buildFrameGraphs(FrameResources &frame)
+{
+    frame.prepassGraph.reset();
+    frame.computeGraph.reset();
+    frame.graphMode = m_renderingMode;
+    frame.graphDirty = false;
+    frame.historyZBuffer = m_renderingMode == eRenderingMode::RENDERING_MODE_TEMPORAL_HI_ZBUFFER ? getTemporalHistory(frame) : vk::Image{};
+
+    const vk::ImageSubresourceRange fullRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+    const auto clearStage = vk::PipelineStageFlagBits2::eClear;
+    const auto clearAccess = vk::AccessFlagBits2::eTransferWrite;
+    const auto computeStage = vk::PipelineStageFlagBits2::eComputeShader;
+    const auto shaderRead = vk::AccessFlagBits2::eShaderRead;
+    const auto shaderWrite = vk::AccessFlagBits2::eShaderWrite;
+    const auto shaderRW = shaderRead | shaderWrite;
+
+    // draws the whole model in a pass without attachments, fragment shaders write storage images only
+    auto drawModel = [this](vk::CommandBuffer &cmdBuffer, vk::Pipeline pipeline)
     {
         // just a copy in order to pass compile
         vk::DeviceSize offset{0ULL};
@@ -482,82 +577,810 @@ void ApplicationBase::render(vk::CommandBuffer &cmdBuffer)
 
         m_zPrepassRenderingInfo.setRenderArea({{}, m_size});
         cmdBuffer.beginRendering(m_zPrepassRenderingInfo);
-
-        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_zPrepassPipeline);
-        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_zPrepassPipelinelayout, 0, m_zBufferSet, {});
-        cmdBuffer.pushConstants(m_zPrepassPipelinelayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0ULL, sizeof(PushConstants), &m_pushConstants);
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
         cmdBuffer.setViewport(0, vk::Viewport(.0f, .0f, m_mainWindow.Width, m_mainWindow.Height, .0f, 1.f));
         cmdBuffer.setScissor(0, vk::Rect2D({}, {static_cast<uint32_t>(m_mainWindow.Width), static_cast<uint32_t>(m_mainWindow.Height)}));
         cmdBuffer.bindVertexBuffers(0, vertexBuffer, offset);
         cmdBuffer.bindIndexBuffer(indexBuffer, offset, vk::IndexType::eUint32);
         cmdBuffer.drawIndexed(m_triangleCount * 3, 1, 0, 0, 0);
-
         cmdBuffer.endRendering();
+    };
 
-        cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, m_shaderRWBarrier});
+    // single pass downsampler, the counter lets the last of its workgroups build the tail mips
+    // min pyramid starts at mip 1 of the z-buffer, its levels match the z-buffer ones from there on
+    // texels past the tiles of the dispatch are never written, the downsampler clamps its loads to the written ones
+    // and culling only reads inside the render extent, so the uncleared min transient is never read past what was written
+    const auto targetExtent = m_targetPool.getExtent(frame.zBufferTarget);
+    const uint32_t zBufferMinMipCount = std::max(std::min<uint32_t>(static_cast<uint32_t>(std::floor(std::log2(std::max(targetExtent.width, targetExtent.height)))) + 1, MAX_ZBUFFER_MIP_COUNT), 2U) - 1U;
+    auto addZBufferMipMapping = [&](RenderGraph &graph, RenderGraph::ResourceHandle zBuffer)
+    {
+        vk::ImageCreateInfo mipCounterCreateInfo{};
+        mipCounterCreateInfo.setImageType(vk::ImageType::e2D)
+            .setFormat(vk::Format::eR32Uint)
+            .setExtent(vk::Extent3D{1U, 1U, 1U})
+            .setMipLevels(1U)
+            .setArrayLayers(1U)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst)
+            .setSharingMode(vk::SharingMode::eExclusive);
+        const auto mipCounter = graph.createImage("z-buffer mip counter", mipCounterCreateInfo);
+        vk::ImageCreateInfo zBufferMinCreateInfo{mipCounterCreateInfo};
+        zBufferMinCreateInfo.setFormat(vk::Format::eR32Sfloat)
+            .setExtent(vk::Extent3D{std::max(targetExtent.width / 2U, 1U), std::max(targetExtent.height / 2U, 1U), 1U})
+            .setMipLevels(zBufferMinMipCount)
+            .setUsage(vk::ImageUsageFlagBits::eStorage);
+        const auto zBufferMin = graph.createImage("z-buffer min", zBufferMinCreateInfo);
 
-        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_zBufferMipMappingPipeline);
-        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_zBufferMipMappingPipelineLayout, 0, m_zBufferSet, {});
-        cmdBuffer.pushConstants(m_zBufferMipMappingPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0ULL, sizeof(PushConstants), &m_pushConstants);
-        cmdBuffer.dispatch(calWorkGroupCount(m_size.width, 8), calWorkGroupCount(m_size.height, 8), 1);
-        if (m_renderingMode == eRenderingMode::RENDERING_MODE_OPTIM_HI_ZBUFFER)
+        graph.addPass("z-buffer mip counter clear", [&graph, mipCounter](vk::CommandBuffer &cmdBuffer)
+                      { cmdBuffer.clearColorImage(graph.getImage(mipCounter), vk::ImageLayout::eGeneral, vk::ClearColorValue{0, 0, 0, 0},
+                                                  vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS}); })
+            .discard(mipCounter, clearStage, clearAccess);
+
+        graph.addPass("z-buffer mip mapping", [this](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_zBufferMipMappingPipeline);
+                cmdBuffer.dispatch(calWorkGroupCount(m_size.width, 64), calWorkGroupCount(m_size.height, 64), 1); })
+            .write(zBuffer, computeStage, shaderRW)
+            .discard(zBufferMin, computeStage, shaderRW)
+            .write(mipCounter, computeStage, shaderRW);
+        return std::make_pair(mipCounter, zBufferMin);
+    };
+    // transients are placed by compile, so their slots are set afterwards
+    auto setZBufferMipSlots = [&](const RenderGraph &graph, RenderGraph::ResourceHandle mipCounter, RenderGraph::ResourceHandle zBufferMin)
+    {
+        m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_ZBUFFER_MIP_COUNTER, graph.getImageView(mipCounter));
+        for (auto i = 0U; i < zBufferMinMipCount; ++i)
+            m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_ZBUFFER_MIN_MIP + i, graph.getImageView(zBufferMin, i));
+    };
+
+    // lsd radix sort of the pairs in the first sort buffer, the global property gives the key count & block dispatch
+    // passes ping-pong between both sort buffers, an even pass count leaves the result in the first one
+    auto addRadixSort = [&](RenderGraph &graph, RenderGraph::ResourceHandle globalProperty, const std::array<RenderGraph::ResourceHandle, 2> &sortPairs)
+    {
+        const auto sortHistogram = graph.importBuffer("scanline sort histogram", *frame.scanlineSortHistogram);
+        for (uint32_t pass = 0; pass < RADIX_SORT_PASS_COUNT; ++pass)
         {
-            cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_octreeInitPipeline);
-            cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_octreeInitPipelineLayout, 0, {m_geometrySet, m_octreeSet, m_zBufferSet}, {});
-            cmdBuffer.pushConstants(m_octreeInitPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0ULL, sizeof(PushConstants), &m_pushConstants);
-            cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount * 3, 1024), 1, 1);
+            const auto source = sortPairs[pass & 1U], destination = sortPairs[(pass & 1U) ^ 1U];
+            const std::string suffix = " " + std::to_string(pass);
+            // the digit of the pass is read by the sort shaders from the global property buffer
+            graph.addPass("radix sort pass" + suffix, [&frame, pass](vk::CommandBuffer &cmdBuffer)
+                          { cmdBuffer.updateBuffer(*frame.scanlineGlobalPropertyBuffer, offsetof(ScanlineGlobalProperty, sortPass), sizeof(uint32_t), &pass); })
+                .write(globalProperty, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+            graph.addPass("radix sort histogram" + suffix, [this, &frame](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_radixSortHistogramPipeline);
+                    cmdBuffer.dispatchIndirect(*frame.scanlineGlobalPropertyBuffer, offsetof(ScanlineGlobalProperty, sortWorkgroupCount)); })
+                .read(globalProperty, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+                .read(globalProperty, computeStage, shaderRead)
+                .read(source, computeStage, shaderRead)
+                .discard(sortHistogram, computeStage, shaderWrite);
+
+            graph.addPass("radix sort scan" + suffix, [this](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_radixSortScanPipeline);
+                    cmdBuffer.dispatch(1, 1, 1); })
+                .read(globalProperty, computeStage, shaderRead)
+                .write(sortHistogram, computeStage, shaderRW);
+
+            graph.addPass("radix sort scatter" + suffix, [this, &frame](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_radixSortScatterPipeline);
+                    cmdBuffer.dispatchIndirect(*frame.scanlineGlobalPropertyBuffer, offsetof(ScanlineGlobalProperty, sortWorkgroupCount)); })
+                .read(globalProperty, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+                .read(globalProperty, computeStage, shaderRead)
+                .read(source, computeStage, shaderRead)
+                .read(sortHistogram, computeStage, shaderRead)
+                .discard(destination, computeStage, shaderWrite);
         }
+    };
 
-        cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, m_shaderRWBarrier});
+    // visibility resolves on graphics queue only, its single transient is consumed by the post render pass
+    if (isVisibilityMode())
+    {
+        auto &graph = frame.prepassGraph;
+        vk::ImageCreateInfo visibilityCreateInfo{};
+        visibilityCreateInfo.setImageType(vk::ImageType::e2D)
+            .setFormat(m_imageInt64AtomicsSupported ? vk::Format::eR64Uint : vk::Format::eR32Uint)
+            .setExtent(m_targetPool.getExtent(frame.zBufferTarget))
+            .setMipLevels(1U)
+            .setArrayLayers(1U)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst)
+            .setSharingMode(vk::SharingMode::eExclusive);
+        const auto visibilityBuffer = graph.createImage("visibility buffer", visibilityCreateInfo);
 
-        switch (m_renderingMode)
+        graph.addPass("visibility clear", [&frame, visibilityBuffer](vk::CommandBuffer &cmdBuffer)
+                      { cmdBuffer.clearColorImage(frame.prepassGraph.getImage(visibilityBuffer), vk::ImageLayout::eGeneral, vk::ClearColorValue{0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU},
+                                                  vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS}); })
+            .discard(visibilityBuffer, clearStage, clearAccess);
+
+        if (m_renderingMode == eRenderingMode::RENDERING_MODE_HYBRID_VISIBILITY_BUFFER)
         {
-        case eRenderingMode::RENDERING_MODE_NAIVE_HI_ZBUFFER:
-            cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_naiveHiZBufferWorkPipeline);
-            cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_hiZBufferOutputPipelineLayout, 0, {m_geometrySet, m_zBufferSet, m_hiZOutputSet, m_octreeSet}, {});
-            cmdBuffer.pushConstants(m_hiZBufferOutputPipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute, 0ULL, sizeof(PushConstants), &m_pushConstants);
-            cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount, 1024), 1, 1);
-            break;
-        case eRenderingMode::RENDERING_MODE_OPTIM_HI_ZBUFFER:
-            for (auto i = m_octreeStartLevel; i < m_octreeLevelCount; ++i)
-            {
+            // most faces of dense meshes cover a pixel or less, they are rasterized in compute with the same atomic min
+            // and only the large ones, compacted with their face ids, go through the hardware rasterizer
+            const auto hiZOutputIndex = graph.importBuffer("hi-z output index", *frame.hiZOutputIndexBuffer);
+            const auto hiZIndirect = graph.importBuffer("hi-z indirect", *frame.hiZIndirectRenderBuffer);
+            const auto largeFaces = graph.importBuffer("hybrid large faces", *frame.hiZRejectedFaces);
+            graph.addPass("hybrid reset", [&frame](vk::CommandBuffer &cmdBuffer)
+                          {
+                    const vk::DrawIndexedIndirectCommand emptyIndirect{0U, 1U, 0U, 0, 0U};
+                    cmdBuffer.updateBuffer(*frame.hiZIndirectRenderBuffer, 0ULL, sizeof(emptyIndirect), &emptyIndirect); })
+                .discard(hiZIndirect, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+            graph.addPass("hybrid software raster", [this](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_hybridRasterPipeline);
+                    cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount, 1024), 1, 1); })
+                .write(visibilityBuffer, computeStage, shaderRW)
+                .discard(hiZOutputIndex, computeStage, shaderWrite)
+                .write(hiZIndirect, computeStage, shaderRW)
+                .discard(largeFaces, computeStage, shaderWrite);
+
+            graph.addPass("hybrid hardware raster", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                          {
+                    // just a copy in order to pass compile
+                    vk::DeviceSize offset{0ULL};
+                    vk::Buffer vertexBuffer{*m_vertexBuffer};
+
+                    m_zPrepassRenderingInfo.setRenderArea({{}, m_size});
+                    cmdBuffer.beginRendering(m_zPrepassRenderingInfo);
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_visibilityHybridRasterPipeline);
+                    cmdBuffer.setViewport(0, vk::Viewport(.0f, .0f, m_mainWindow.Width, m_mainWindow.Height, .0f, 1.f));
+                    cmdBuffer.setScissor(0, vk::Rect2D({}, {static_cast<uint32_t>(m_mainWindow.Width), static_cast<uint32_t>(m_mainWindow.Height)}));
+                    cmdBuffer.bindVertexBuffers(0, vertexBuffer, offset);
+                    cmdBuffer.bindIndexBuffer(*frame.hiZOutputIndexBuffer, offset, vk::IndexType::eUint32);
+                    cmdBuffer.drawIndexedIndirect(*frame.hiZIndirectRenderBuffer, offset, 1, sizeof(vk::DrawIndexedIndirectCommand));
+                    cmdBuffer.endRendering(); })
+                .read(hiZOutputIndex, vk::PipelineStageFlagBits2::eIndexInput, vk::AccessFlagBits2::eIndexRead)
+                .read(hiZIndirect, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+                .read(largeFaces, vk::PipelineStageFlagBits2::eFragmentShader, shaderRead)
+                .write(visibilityBuffer, vk::PipelineStageFlagBits2::eFragmentShader, shaderRW);
+        }
+        else
+            graph.addPass("visibility raster", [this, drawModel](vk::CommandBuffer &cmdBuffer)
+                          { drawModel(cmdBuffer, m_visibilityRasterPipeline); })
+                .write(visibilityBuffer, vk::PipelineStageFlagBits2::eFragmentShader, shaderRW);
+
+        // post render pass waits on the prepass semaphore, the barrier covers the rest
+        graph.markOutput(visibilityBuffer, {vk::PipelineStageFlagBits2::eFragmentShader, shaderRead});
+        graph.compile(m_renderContext);
+
+        m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_VISIBILITY_BUFFER, graph.getImageView(visibilityBuffer));
+        m_descriptorHeap.flush();
+        return;
+    }
+
+    // temporal hi-z stays on graphics queue, since its survivors are rasterized between the two culling phases
+    // faces passing the reprojected pyramid of the previous frame build this frame's pyramid, the rejected ones are tested again against it
+    if (m_renderingMode == eRenderingMode::RENDERING_MODE_TEMPORAL_HI_ZBUFFER)
+    {
+        auto &graph = frame.prepassGraph;
+        // the frame in between has read this z-buffer as its history
+        const auto zBuffer = graph.importImage("z-buffer", frame.zBuffer, fullRange, {computeStage, shaderRead});
+        const auto emptyBuffer = graph.importImage("empty buffer", frame.emptyBuffer, fullRange);
+        const auto hiZOutputIndex = graph.importBuffer("hi-z output index", *frame.hiZOutputIndexBuffer);
+        const auto hiZIndirect = graph.importBuffer("hi-z indirect", *frame.hiZIndirectRenderBuffer);
+        const auto rejectedFaces = graph.importBuffer("hi-z rejected faces", *frame.hiZRejectedFaces);
+
+        graph.addPass("clear", [&frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.clearColorImage(frame.zBuffer, vk::ImageLayout::eGeneral, vk::ClearColorValue{0x7F7FFFFF, 0, 0, 0}, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+                cmdBuffer.clearColorImage(frame.emptyBuffer, vk::ImageLayout::eGeneral, vk::ClearColorValue{0x7F7FFFFF, 0, 0, 0}, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS}); })
+            .discard(zBuffer, clearStage, clearAccess)
+            .discard(emptyBuffer, clearStage, clearAccess);
+
+        graph.addPass("temporal hi-z reset", [&frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                const vk::DrawIndexedIndirectCommand emptyIndirect{0U, 1U, 0U, 0, 0U};
+                const glm::uvec4 emptyRejected{0U, 1U, 1U, 0U};
+                cmdBuffer.updateBuffer(*frame.hiZIndirectRenderBuffer, 0ULL, sizeof(emptyIndirect), &emptyIndirect);
+                cmdBuffer.updateBuffer(*frame.hiZRejectedFaces, 0ULL, sizeof(glm::uvec4), &emptyRejected); })
+            .discard(hiZIndirect, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite)
+            .discard(rejectedFaces, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+        auto firstPhase = graph.addPass("temporal hi-z culling", [this](vk::CommandBuffer &cmdBuffer)
+                                        {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_temporalHiZCullingPipeline);
+                cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount, 1024), 1, 1); });
+        firstPhase.write(hiZOutputIndex, computeStage, shaderWrite)
+            .write(hiZIndirect, computeStage, shaderRW)
+            .write(rejectedFaces, computeStage, shaderRW);
+        // the previous frame wrote its pyramid on this queue, mip 0 by rasterization and the rest by the downsampler
+        if (frame.historyZBuffer)
+            firstPhase.read(graph.importImage("z-buffer history", frame.historyZBuffer, fullRange, {vk::PipelineStageFlagBits2::eFragmentShader | computeStage, shaderWrite}),
+                            computeStage, shaderRead);
+
+        graph.addPass("temporal z raster", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                // just a copy in order to pass compile
+                vk::DeviceSize offset{0ULL};
+                vk::Buffer vertexBuffer{*m_vertexBuffer};
+
+                m_zPrepassRenderingInfo.setRenderArea({{}, m_size});
+                cmdBuffer.beginRendering(m_zPrepassRenderingInfo);
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_zPrepassPipeline);
+                cmdBuffer.setViewport(0, vk::Viewport(.0f, .0f, m_mainWindow.Width, m_mainWindow.Height, .0f, 1.f));
+                cmdBuffer.setScissor(0, vk::Rect2D({}, {static_cast<uint32_t>(m_mainWindow.Width), static_cast<uint32_t>(m_mainWindow.Height)}));
+                cmdBuffer.bindVertexBuffers(0, vertexBuffer, offset);
+                cmdBuffer.bindIndexBuffer(*frame.hiZOutputIndexBuffer, offset, vk::IndexType::eUint32);
+                cmdBuffer.drawIndexedIndirect(*frame.hiZIndirectRenderBuffer, offset, 1, sizeof(vk::DrawIndexedIndirectCommand));
+                cmdBuffer.endRendering(); })
+            .read(hiZOutputIndex, vk::PipelineStageFlagBits2::eIndexInput, vk::AccessFlagBits2::eIndexRead)
+            .read(hiZIndirect, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+            .write(zBuffer, vk::PipelineStageFlagBits2::eFragmentShader, shaderRW);
+
+        const auto [mipCounter, zBufferMin] = addZBufferMipMapping(graph, zBuffer);
+
+        graph.addPass("temporal hi-z recheck", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_temporalHiZRecheckPipeline);
+                cmdBuffer.dispatchIndirect(*frame.hiZRejectedFaces, 0ULL); })
+            .read(zBuffer, computeStage, shaderRead)
+            .read(zBufferMin, computeStage, shaderRead)
+            .read(rejectedFaces, vk::PipelineStageFlagBits2::eDrawIndirect | computeStage, vk::AccessFlagBits2::eIndirectCommandRead | shaderRead)
+            .write(hiZOutputIndex, computeStage, shaderWrite)
+            .write(hiZIndirect, computeStage, shaderRW);
+
+        // post render pass waits on the prepass semaphore, the barriers cover the rest
+        // the z-buffer pyramid is kept as history of the next frame, which imports it with its own barrier
+        graph.markOutput(hiZOutputIndex, {vk::PipelineStageFlagBits2::eIndexInput | vk::PipelineStageFlagBits2::eFragmentShader,
+                                          vk::AccessFlagBits2::eIndexRead | vk::AccessFlagBits2::eShaderStorageRead});
+        graph.markOutput(hiZIndirect, {vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead});
+        graph.markOutput(emptyBuffer, {vk::PipelineStageFlagBits2::eFragmentShader, shaderRW});
+        graph.markOutput(zBuffer);
+        graph.compile(m_renderContext);
+
+        setZBufferMipSlots(graph, mipCounter, zBufferMin);
+        m_descriptorHeap.flush();
+        return;
+    }
+
+    if (usePrepass())
+    {
+        auto &graph = frame.prepassGraph;
+        const auto zBuffer = graph.importImage("z-buffer", frame.zBuffer, fullRange);
+        const auto emptyBuffer = graph.importImage("empty buffer", frame.emptyBuffer, fullRange);
+
+        graph.addPass("clear", [&frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.clearColorImage(frame.zBuffer, vk::ImageLayout::eGeneral, vk::ClearColorValue{0x7F7FFFFF, 0, 0, 0}, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+                cmdBuffer.clearColorImage(frame.emptyBuffer, vk::ImageLayout::eGeneral, vk::ClearColorValue{0x7F7FFFFF, 0, 0, 0}, vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS}); })
+            .discard(zBuffer, clearStage, clearAccess)
+            .discard(emptyBuffer, clearStage, clearAccess);
+
+        graph.addPass("z prepass", [this, drawModel](vk::CommandBuffer &cmdBuffer)
+                      { drawModel(cmdBuffer, m_zPrepassPipeline); })
+            .write(zBuffer, vk::PipelineStageFlagBits2::eFragmentShader, shaderRW);
+
+        // z-buffer is released to compute queue by hand, empty buffer stays for hi-z post rendering
+        graph.markOutput(zBuffer);
+        graph.markOutput(emptyBuffer, {vk::PipelineStageFlagBits2::eFragmentShader, shaderRW});
+        graph.compile(m_renderContext);
+    }
+
+    if (!useAsyncCompute())
+        return;
+
+    auto &graph = frame.computeGraph;
+    const auto zBuffer = graph.importImage("z-buffer", frame.zBuffer, fullRange);
+    if (isScanlineMode())
+    {
+        const bool tiled = m_renderingMode == eRenderingMode::RENDERING_MODE_TILED_SCANLINE_ZBUFFER;
+        vk::ImageCreateInfo scanlineImageCreateInfo{};
+        scanlineImageCreateInfo.setImageType(vk::ImageType::e2D)
+            .setFormat(vk::Format::eR32Uint)
+            .setExtent(m_targetPool.getExtent(frame.zBufferTarget))
+            .setMipLevels(1U)
+            .setArrayLayers(1U)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferDst)
+            .setSharingMode(vk::SharingMode::eExclusive);
+        const auto colorBuffer = graph.importImage("color buffer", frame.colorBuffer, fullRange);
+        const auto scanlineBuffer = graph.importBuffer("scanline buffer", *frame.scanlineBuffer);
+        const auto globalProperty = graph.importBuffer("scanline global property", *frame.scanlineGlobalPropertyBuffer);
+        const auto segmentOffsets = graph.importBuffer("scanline segment offsets", *frame.scanlineSegmentOffsets);
+        const std::array sortPairs{graph.importBuffer("scanline sort pairs 0", *frame.scanlineSortPairs[0]),
+                                   graph.importBuffer("scanline sort pairs 1", *frame.scanlineSortPairs[1])};
+
+        // init only grows the scanline count and workgroup counts, so they start from empty dispatches
+        graph.addPass("scanline reset", [&frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                const std::array<glm::uvec4, 3> emptyProperty{glm::uvec4{0U, 1U, 1U, 0U}, glm::uvec4{0U, 1U, 1U, 0U}, glm::uvec4{0U, 1U, 1U, 0U}};
+                cmdBuffer.updateBuffer(*frame.scanlineGlobalPropertyBuffer, 0ULL, sizeof(emptyProperty), emptyProperty.data()); })
+            .discard(globalProperty, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+        graph.addPass("scanline init", [this](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineZBufferInitPipeline);
+                cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount, 1024), 1, 1); })
+            .write(scanlineBuffer, computeStage, shaderWrite)
+            .write(segmentOffsets, computeStage, shaderWrite)
+            .write(sortPairs[0], computeStage, shaderWrite)
+            .write(globalProperty, computeStage, shaderRW);
+
+        // spans sorted by row & far depth, then every row is painted back to front by pixel owning invocations
+        if (m_renderingMode == eRenderingMode::RENDERING_MODE_PAINTER_SCANLINE_ZBUFFER)
+        {
+            addRadixSort(graph, globalProperty, sortPairs);
+
+            // every pixel inside the render extent is written once, so the color buffer needs no clear
+            graph.addPass("scanline painter fill", [this](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlinePainterFillPipeline);
+                    cmdBuffer.dispatch(m_size.height, 1, 1); })
+                .read(globalProperty, computeStage, shaderRead)
+                .read(scanlineBuffer, computeStage, shaderRead)
+                .read(sortPairs[0], computeStage, shaderRead)
+                .discard(colorBuffer, computeStage, shaderWrite);
+
+            // released to graphics queue by hand
+            graph.markOutput(colorBuffer);
+            graph.compile(m_renderContext);
+            return;
+        }
+
+        // work passes split spans into fixed width segments, so threads get even work whatever the triangle sizes
+        if (!tiled)
+            graph.addPass("scanline segment scan", [this](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineSegmentScanPipeline);
+                    cmdBuffer.dispatch(1, 1, 1); })
+                .write(segmentOffsets, computeStage, shaderRW)
+                .write(globalProperty, computeStage, shaderRW);
+
+        // depth & face index packed into one value, a single atomic min per pixel instead of the spinlock
+        if (m_renderingMode == eRenderingMode::RENDERING_MODE_PACKED_SCANLINE_ZBUFFER)
+        {
+            scanlineImageCreateInfo.setFormat(m_imageInt64AtomicsSupported ? vk::Format::eR64Uint : vk::Format::eR32Uint);
+            const auto visibilityBuffer = graph.createImage("scanline visibility buffer", scanlineImageCreateInfo);
+
+            graph.addPass("scanline visibility clear", [&frame, visibilityBuffer](vk::CommandBuffer &cmdBuffer)
+                          { cmdBuffer.clearColorImage(frame.computeGraph.getImage(visibilityBuffer), vk::ImageLayout::eGeneral, vk::ClearColorValue{0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU},
+                                                      vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS}); })
+                .discard(visibilityBuffer, clearStage, clearAccess);
+
+            graph.addPass("scanline packed work", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlinePackedWorkPipeline);
+                    cmdBuffer.dispatchIndirect(*frame.scanlineGlobalPropertyBuffer, offsetof(ScanlineGlobalProperty, segmentWorkgroupCount)); })
+                .read(globalProperty, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+                .read(globalProperty, computeStage, shaderRead)
+                .read(scanlineBuffer, computeStage, shaderRead)
+                .read(segmentOffsets, computeStage, shaderRead)
+                .write(visibilityBuffer, computeStage, shaderRW);
+
+            // every pixel inside the render extent is written once, so the color buffer needs no clear
+            graph.addPass("scanline packed resolve", [this](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlinePackedResolvePipeline);
+                    cmdBuffer.dispatch(calWorkGroupCount(m_size.width, 8), calWorkGroupCount(m_size.height, 8), 1); })
+                .read(visibilityBuffer, computeStage, shaderRead)
+                .discard(colorBuffer, computeStage, shaderWrite);
+
+            // released to graphics queue by hand
+            graph.markOutput(colorBuffer);
+            graph.compile(m_renderContext);
+
+            m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_VISIBILITY_BUFFER, graph.getImageView(visibilityBuffer));
+            m_descriptorHeap.flush();
+            return;
+        }
+
+        if (!tiled)
+        {
+            const auto spinlock = graph.createImage("scanline spinlock", scanlineImageCreateInfo);
+            graph.addPass("scanline clear", [&frame, spinlock](vk::CommandBuffer &cmdBuffer)
+                          {
+                    const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+                    cmdBuffer.clearColorImage(frame.zBuffer, vk::ImageLayout::eGeneral, vk::ClearColorValue{0x7F7FFFFF, 0, 0, 0}, range);
+                    cmdBuffer.clearColorImage(frame.computeGraph.getImage(spinlock), vk::ImageLayout::eGeneral, vk::ClearColorValue{0, 0, 0, 0}, range);
+                    cmdBuffer.clearColorImage(frame.colorBuffer, vk::ImageLayout::eGeneral, vk::ClearColorValue{0, 0, 0, 0}, range); })
+                .discard(zBuffer, clearStage, clearAccess)
+                .discard(spinlock, clearStage, clearAccess)
+                .discard(colorBuffer, clearStage, clearAccess);
+
+            graph.addPass("scanline work", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineZBufferWorkPipeline);
+                    cmdBuffer.dispatchIndirect(*frame.scanlineGlobalPropertyBuffer, offsetof(ScanlineGlobalProperty, segmentWorkgroupCount)); })
+                .read(globalProperty, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+                .read(globalProperty, computeStage, shaderRead)
+                .read(scanlineBuffer, computeStage, shaderRead)
+                .read(segmentOffsets, computeStage, shaderRead)
+                .write(zBuffer, computeStage, shaderRW)
+                .write(spinlock, computeStage, shaderRW)
+                .write(colorBuffer, computeStage, shaderRW);
+
+            // released to graphics queue by hand
+            graph.markOutput(colorBuffer);
+            graph.compile(m_renderContext);
+
+            m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_SPINLOCK, graph.getImageView(spinlock));
+            m_descriptorHeap.flush();
+            return;
+        }
+
+        // spans are binned per screen tile, then every tile resolves its spans in shared memory without a spinlock
+        scanlineImageCreateInfo.setExtent(vk::Extent3D{static_cast<uint32_t>(calWorkGroupCount(targetExtent.width, SCANLINE_TILE_SIZE)),
+                                             static_cast<uint32_t>(calWorkGroupCount(targetExtent.height, SCANLINE_TILE_SIZE)), 1U});
+        const auto tileCounts = graph.createImage("scanline tile counts", scanlineImageCreateInfo);
+        const auto tileOffsets = graph.createImage("scanline tile offsets", scanlineImageCreateInfo);
+        const auto tileEntries = graph.importBuffer("scanline tile entries", *frame.scanlineTileEntries);
+
+        graph.addPass("scanline tile clear", [&frame, tileCounts](vk::CommandBuffer &cmdBuffer)
+                      { cmdBuffer.clearColorImage(frame.computeGraph.getImage(tileCounts), vk::ImageLayout::eGeneral, vk::ClearColorValue{0, 0, 0, 0},
+                                                  vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS}); })
+            .discard(tileCounts, clearStage, clearAccess);
+
+        graph.addPass("scanline tile count", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineTileCountPipeline);
+                cmdBuffer.dispatchIndirect(*frame.scanlineGlobalPropertyBuffer, 0ULL); })
+            .read(globalProperty, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+            .read(globalProperty, computeStage, shaderRead)
+            .read(scanlineBuffer, computeStage, shaderRead)
+            .write(tileCounts, computeStage, shaderRW);
+
+        graph.addPass("scanline tile scan", [this](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineTileScanPipeline);
+                cmdBuffer.dispatch(1, 1, 1); })
+            .write(tileCounts, computeStage, shaderRW)
+            .discard(tileOffsets, computeStage, shaderWrite);
+
+        graph.addPass("scanline tile scatter", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineTileScatterPipeline);
+                cmdBuffer.dispatchIndirect(*frame.scanlineGlobalPropertyBuffer, 0ULL); })
+            .read(globalProperty, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+            .read(globalProperty, computeStage, shaderRead)
+            .read(scanlineBuffer, computeStage, shaderRead)
+            .read(tileOffsets, computeStage, shaderRead)
+            .write(tileCounts, computeStage, shaderRW)
+            .write(tileEntries, computeStage, shaderWrite);
+
+        // every pixel inside the render extent is written once, so neither target needs a clear
+        graph.addPass("scanline tile resolve", [this](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_scanlineTileResolvePipeline);
+                cmdBuffer.dispatch(calWorkGroupCount(m_size.width, SCANLINE_TILE_SIZE), calWorkGroupCount(m_size.height, SCANLINE_TILE_SIZE), 1); })
+            .read(scanlineBuffer, computeStage, shaderRead)
+            .read(tileCounts, computeStage, shaderRead)
+            .read(tileOffsets, computeStage, shaderRead)
+            .read(tileEntries, computeStage, shaderRead)
+            .discard(zBuffer, computeStage, shaderWrite)
+            .discard(colorBuffer, computeStage, shaderWrite);
+
+        // released to graphics queue by hand
+        graph.markOutput(colorBuffer);
+        graph.compile(m_renderContext);
+
+        m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_SCANLINE_TILE_COUNT, graph.getImageView(tileCounts));
+        m_descriptorHeap.setStorageImage(frame.imageHeapBase + SLOT_SCANLINE_TILE_OFFSET, graph.getImageView(tileOffsets));
+        m_descriptorHeap.flush();
+        return;
+    }
+
+    const auto hiZOutputIndex = graph.importBuffer("hi-z output index", *frame.hiZOutputIndexBuffer);
+    const auto hiZIndirect = graph.importBuffer("hi-z indirect", *frame.hiZIndirectRenderBuffer);
+    // culling passes only append to the draw, so it starts from an empty one
+    graph.addPass("hi-z reset", [&frame](vk::CommandBuffer &cmdBuffer)
+                  {
+            const vk::DrawIndexedIndirectCommand emptyIndirect{0U, 1U, 0U, 0, 0U};
+            cmdBuffer.updateBuffer(*frame.hiZIndirectRenderBuffer, 0ULL, sizeof(emptyIndirect), &emptyIndirect); })
+        .discard(hiZIndirect, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+    const bool useOctree = m_renderingMode == eRenderingMode::RENDERING_MODE_OPTIM_HI_ZBUFFER;
+    const auto [mipCounter, zBufferMin] = addZBufferMipMapping(graph, zBuffer);
+
+    if (useOctree)
+    {
+        // the static octree is walked by one persistent dispatch, visible inner nodes push their children nearest first
+        // and visible leaves queue themselves, only faces of those leaves are ever tested one by one
+        const auto octreeQueues = graph.importBuffer("octree queues", *frame.octreeQueues);
+        graph.addPass("octree reset", [&frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                // empty leaf queue, then head, tail & done counters with the root pushed into the first slot
+                const std::array<uint32_t, 8> initialQueues{0U, 1U, 1U, 0U, 0U, 1U, 0U, 0U};
+                cmdBuffer.updateBuffer(*frame.octreeQueues, 0ULL, sizeof(initialQueues), initialQueues.data());
+                // the remaining slots are marked as not pushed yet, the leaf queue behind them is filled along harmlessly
+                cmdBuffer.fillBuffer(*frame.octreeQueues, sizeof(initialQueues), vk::WholeSize, 0xFFFFFFFFU); })
+            .discard(octreeQueues, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+        graph.addPass("optim hi-z culling", [this](vk::CommandBuffer &cmdBuffer)
+                      {
                 cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_optimHiZBufferWorkPipeline);
-                cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_hiZBufferOutputPipelineLayout, 0, {m_geometrySet, m_zBufferSet, m_hiZOutputSet, m_octreeSet}, {});
-                cmdBuffer.pushConstants(m_hiZBufferOutputPipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute, 0ULL, sizeof(PushConstants), &m_pushConstants);
-                cmdBuffer.dispatch(calWorkGroupCount(1 << i, 8), calWorkGroupCount(1 << i, 8), 1);
-                cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, m_shaderRWBarrier});
-            }
-            break;
+                cmdBuffer.dispatch(OCTREE_TRAVERSAL_WORKGROUP_COUNT, 1, 1); })
+            .write(octreeQueues, computeStage, shaderRW)
+            .read(zBuffer, computeStage, shaderRead)
+            .read(zBufferMin, computeStage, shaderRead);
+
+        graph.addPass("octree leaf culling", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_octreeLeafCullingPipeline);
+                cmdBuffer.dispatchIndirect(*frame.octreeQueues, 0ULL); })
+            .read(octreeQueues, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+            .read(octreeQueues, computeStage, shaderRead)
+            .read(zBuffer, computeStage, shaderRead)
+            .read(zBufferMin, computeStage, shaderRead)
+            .write(hiZOutputIndex, computeStage, shaderWrite)
+            .write(hiZIndirect, computeStage, shaderRW);
+    }
+    else if (m_renderingMode == eRenderingMode::RENDERING_MODE_LBVH_HI_ZBUFFER && m_triangleCount == 0)
+    {
+        // a model without faces has no tree: node 0 would be seeded as the root but never written by the build,
+        // and with triangleCount - 1 wrapping it would pass for an inner node, so nothing is traversed and the draw stays empty
+    }
+    else if (m_renderingMode == eRenderingMode::RENDERING_MODE_LBVH_HI_ZBUFFER)
+    {
+        // the lbvh is rebuilt from scratch every frame: morton codes, radix sort, hierarchy & bottom up refit
+        const auto globalProperty = graph.importBuffer("scanline global property", *frame.scanlineGlobalPropertyBuffer);
+        const std::array sortPairs{graph.importBuffer("scanline sort pairs 0", *frame.scanlineSortPairs[0]),
+                                   graph.importBuffer("scanline sort pairs 1", *frame.scanlineSortPairs[1])};
+        const auto lbvhNodes = graph.importBuffer("lbvh nodes", *frame.lbvhNodes);
+        const auto lbvhQueues = graph.importBuffer("lbvh queues", *frame.lbvhQueues);
+
+        graph.addPass("lbvh reset", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                // the sort takes one key per face, scanline parts of the global property stay empty
+                ScanlineGlobalProperty sortProperty{};
+                sortProperty.workgroupCount = sortProperty.segmentWorkgroupCount = glm::uvec3{0U, 1U, 1U};
+                sortProperty.scanlineCount = static_cast<uint32_t>(m_triangleCount);
+                sortProperty.sortWorkgroupCount = glm::uvec3{static_cast<uint32_t>(calWorkGroupCount(m_triangleCount, RADIX_SORT_BLOCK_SIZE)), 1U, 1U};
+                cmdBuffer.updateBuffer(*frame.scanlineGlobalPropertyBuffer, 0ULL, sizeof(sortProperty), &sortProperty);
+                // the root is the only node of the first level, the other node queue & the subtree queue start empty
+                const std::array<uint32_t, 14> initialQueues{1U, 1U, 1U, 1U, 0U, 1U, 1U, 0U, 0U, 1U, 1U, 0U, 0U, 0U};
+                cmdBuffer.updateBuffer(*frame.lbvhQueues, 0ULL, sizeof(initialQueues), initialQueues.data()); })
+            .discard(globalProperty, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite)
+            .discard(lbvhQueues, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+        graph.addPass("lbvh morton", [this](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_lbvhMortonPipeline);
+                cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount, 1024), 1, 1); })
+            .discard(sortPairs[0], computeStage, shaderWrite);
+
+        addRadixSort(graph, globalProperty, sortPairs);
+
+        graph.addPass("lbvh hierarchy", [this](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_lbvhHierarchyPipeline);
+                cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount, 1024), 1, 1); })
+            .read(sortPairs[0], computeStage, shaderRead)
+            .discard(lbvhNodes, computeStage, shaderWrite);
+
+        graph.addPass("lbvh refit", [this](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_lbvhRefitPipeline);
+                cmdBuffer.dispatch(calWorkGroupCount(m_triangleCount, 1024), 1, 1); })
+            .write(lbvhNodes, computeStage, shaderRW);
+
+        // levels are walked breadth first until the visible nodes hold few faces, then each of those is walked depth first by one invocation
+        // how deep that goes depends on the morton codes, so frontier passes are recorded up to the bound of the tree depth
+        // and their indirect sizes stay empty once the queue runs dry, a node of more faces than a subtree takes is at most n - 65 deep,
+        // so its children are reached by the level n - 64 at the latest
+        const uint32_t frontierLevels = static_cast<uint32_t>(std::min<size_t>(LBVH_MAX_FRONTIER_LEVELS, std::max<size_t>(m_triangleCount, LBVH_SUBTREE_FACE_COUNT) - LBVH_SUBTREE_FACE_COUNT + 1));
+        for (uint32_t level = 0; level < frontierLevels; ++level)
+        {
+            const std::string suffix = " " + std::to_string(level);
+            graph.addPass("lbvh level" + suffix, [&frame, level](vk::CommandBuffer &cmdBuffer)
+                          {
+                    const glm::uvec4 emptyQueue{0U, 1U, 1U, 0U};
+                    cmdBuffer.updateBuffer(*frame.lbvhQueues, sizeof(glm::uvec4) * 3, sizeof(uint32_t), &level);
+                    if (level > 0)
+                        cmdBuffer.updateBuffer(*frame.lbvhQueues, sizeof(glm::uvec4) * ((level + 1) & 1U), sizeof(glm::uvec4), &emptyQueue); })
+                .write(lbvhQueues, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+            graph.addPass("lbvh frontier culling" + suffix, [this, &frame, level](vk::CommandBuffer &cmdBuffer)
+                          {
+                    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_lbvhFrontierPipeline);
+                    cmdBuffer.dispatchIndirect(*frame.lbvhQueues, sizeof(glm::uvec4) * (level & 1U)); })
+                .read(lbvhQueues, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+                .write(lbvhQueues, computeStage, shaderRW)
+                .read(lbvhNodes, computeStage, shaderRead)
+                .read(zBuffer, computeStage, shaderRead)
+                .read(zBufferMin, computeStage, shaderRead)
+                .write(hiZOutputIndex, computeStage, shaderWrite)
+                .write(hiZIndirect, computeStage, shaderRW);
         }
 
-        cmdBuffer.pipelineBarrier2(vk::DependencyInfo{{}, m_shaderRWBarrier});
+        graph.addPass("lbvh subtree culling", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_lbvhSubtreePipeline);
+                cmdBuffer.dispatchIndirect(*frame.lbvhQueues, sizeof(glm::uvec4) * 2); })
+            .read(lbvhQueues, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+            .read(lbvhQueues, computeStage, shaderRead)
+            .read(lbvhNodes, computeStage, shaderRead)
+            .read(zBuffer, computeStage, shaderRead)
+            .read(zBufferMin, computeStage, shaderRead)
+            .write(hiZOutputIndex, computeStage, shaderWrite)
+            .write(hiZIndirect, computeStage, shaderRW);
+    }
+    else
+    {
+        // clusters are culled first, then only faces of the surviving ones are tested one by one
+        const auto visibleClusters = graph.importBuffer("hi-z visible clusters", *frame.hiZVisibleClusters);
+        graph.addPass("hi-z cluster reset", [&frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                const glm::uvec4 emptyClusters{0U, 1U, 1U, 0U};
+                cmdBuffer.updateBuffer(*frame.hiZVisibleClusters, 0ULL, sizeof(glm::uvec4), &emptyClusters); })
+            .discard(visibleClusters, vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+        graph.addPass("hi-z cluster culling", [this](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_hiZClusterCullingPipeline);
+                cmdBuffer.dispatch(calWorkGroupCount(m_clusterCount, 1024), 1, 1); })
+            .read(zBuffer, computeStage, shaderRead)
+            .read(zBufferMin, computeStage, shaderRead)
+            .write(visibleClusters, computeStage, shaderRW);
+
+        graph.addPass("naive hi-z culling", [this, &frame](vk::CommandBuffer &cmdBuffer)
+                      {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_naiveHiZBufferWorkPipeline);
+                cmdBuffer.dispatchIndirect(*frame.hiZVisibleClusters, 0ULL); })
+            .read(visibleClusters, vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead)
+            .read(visibleClusters, computeStage, shaderRead)
+            .read(zBuffer, computeStage, shaderRead)
+            .read(zBufferMin, computeStage, shaderRead)
+            .write(hiZOutputIndex, computeStage, shaderWrite)
+            .write(hiZIndirect, computeStage, shaderRW);
+    }
+
+    // released to graphics queue by hand
+    graph.markOutput(hiZOutputIndex);
+    graph.markOutput(hiZIndirect);
+    graph.compile(m_renderContext);
+
+    setZBufferMipSlots(graph, mipCounter, zBufferMin);
+    m_descriptorHeap.flush();
+}
+
+void ApplicationBase::renderPrepass(vk::CommandBuffer &cmdBuffer, FrameResources &frame)
+{
+    const auto section = frame.profiler.beginSection(cmdBuffer, "graphics prepass");
+    bindDescriptorHeap(cmdBuffer, vk::PipelineBindPoint::eGraphics);
+    frame.prepassGraph.execute(cmdBuffer);
+
+    // release z-buffer to compute queue, the semaphore is enough when both queues share one family
+    if (useAsyncCompute() && m_graphicsQueueFamily != m_computeQueueFamily)
+    {
+        auto barrier = makeImageMemoryBarrier(frame.zBuffer, vk::AccessFlagBits2::eShaderWrite, {},
+                                              vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral,
+                                              vk::ImageAspectFlagBits::eColor)
+                           .setSrcStageMask(vk::PipelineStageFlagBits2::eFragmentShader)
+                           .setSrcQueueFamilyIndex(m_graphicsQueueFamily)
+                           .setDstQueueFamilyIndex(m_computeQueueFamily);
+        vk::DependencyInfo depInfo{};
+        depInfo.setImageMemoryBarriers(barrier);
+        cmdBuffer.pipelineBarrier2(depInfo);
     }
+    frame.profiler.endSection(cmdBuffer, section);
 }
 
-void ApplicationBase::finalBlit(vk::CommandBuffer &cmdBuffer)
+// all compute stages, recorded into the async compute queue
+void ApplicationBase::render(vk::CommandBuffer &cmdBuffer, FrameResources &frame)
+{
+    const auto section = m_computeTimestampSupported ? frame.profiler.beginSection(cmdBuffer, "async compute") : ~0U;
+    const bool transferOwnership = m_graphicsQueueFamily != m_computeQueueFamily;
+    std::vector<vk::ImageMemoryBarrier2> imageReleases{};
+    std::vector<vk::BufferMemoryBarrier2> bufferReleases{};
+    bindDescriptorHeap(cmdBuffer, vk::PipelineBindPoint::eCompute);
+
+    // acquire z-buffer written by prepass
+    if (usePrepass() && transferOwnership)
+    {
+        auto barrier = makeImageMemoryBarrier(frame.zBuffer, {}, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite,
+                                              vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral,
+                                              vk::ImageAspectFlagBits::eColor)
+                           .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                           .setSrcQueueFamilyIndex(m_graphicsQueueFamily)
+                           .setDstQueueFamilyIndex(m_computeQueueFamily);
+        vk::DependencyInfo depInfo{};
+        depInfo.setImageMemoryBarriers(barrier);
+        cmdBuffer.pipelineBarrier2(depInfo);
+    }
+
+    frame.computeGraph.execute(cmdBuffer);
+
+    if (transferOwnership && isScanlineMode())
+        imageReleases.emplace_back(makeImageMemoryBarrier(frame.colorBuffer, vk::AccessFlagBits2::eShaderWrite, {},
+                                                          vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral,
+                                                          vk::ImageAspectFlagBits::eColor)
+                                       .setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                                       .setSrcQueueFamilyIndex(m_computeQueueFamily)
+                                       .setDstQueueFamilyIndex(m_graphicsQueueFamily));
+    else if (transferOwnership && usePrepass())
+    {
+        // dst scopes of a release are ignored, the acquire in acquireComputeResults names the index & fragment reads
+        bufferReleases.emplace_back(makeBufferMemoryBarrier(*frame.hiZOutputIndexBuffer, vk::AccessFlagBits2::eShaderWrite, {})
+                                        .setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                                        .setSrcQueueFamilyIndex(m_computeQueueFamily)
+                                        .setDstQueueFamilyIndex(m_graphicsQueueFamily));
+        bufferReleases.emplace_back(makeBufferMemoryBarrier(*frame.hiZIndirectRenderBuffer, vk::AccessFlagBits2::eShaderWrite, {})
+                                        .setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                                        .setSrcQueueFamilyIndex(m_computeQueueFamily)
+                                        .setDstQueueFamilyIndex(m_graphicsQueueFamily));
+    }
+
+    // release results to graphics queue
+    if (!imageReleases.empty() || !bufferReleases.empty())
+    {
+        vk::DependencyInfo depInfo{};
+        depInfo.setImageMemoryBarriers(imageReleases).setBufferMemoryBarriers(bufferReleases);
+        cmdBuffer.pipelineBarrier2(depInfo);
+    }
+    frame.profiler.endSection(cmdBuffer, section);
+}
+
+// acquire side of the ownership transfer in render(), must match its releases exactly
+void ApplicationBase::acquireComputeResults(vk::CommandBuffer &cmdBuffer, FrameResources &frame)
+{
+    if (m_graphicsQueueFamily == m_computeQueueFamily)
+        return;
+
+    vk::DependencyInfo depInfo{};
+    if (isScanlineMode())
+    {
+        auto barrier = makeImageMemoryBarrier(frame.colorBuffer, {}, vk::AccessFlagBits2::eShaderRead,
+                                              vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral,
+                                              vk::ImageAspectFlagBits::eColor)
+                           .setDstStageMask(vk::PipelineStageFlagBits2::eFragmentShader)
+                           .setSrcQueueFamilyIndex(m_computeQueueFamily)
+                           .setDstQueueFamilyIndex(m_graphicsQueueFamily);
+        depInfo.setImageMemoryBarriers(barrier);
+        cmdBuffer.pipelineBarrier2(depInfo);
+    }
+    else if (usePrepass())
+    {
+        std::array barriers = {
+            // the post render pass reads the surviving faces back from storage to shade them, besides drawing them
+            makeBufferMemoryBarrier(*frame.hiZOutputIndexBuffer, {}, vk::AccessFlagBits2::eIndexRead | vk::AccessFlagBits2::eShaderStorageRead)
+                .setDstStageMask(vk::PipelineStageFlagBits2::eIndexInput | vk::PipelineStageFlagBits2::eFragmentShader)
+                .setSrcQueueFamilyIndex(m_computeQueueFamily)
+                .setDstQueueFamilyIndex(m_graphicsQueueFamily),
+            makeBufferMemoryBarrier(*frame.hiZIndirectRenderBuffer, {}, vk::AccessFlagBits2::eIndirectCommandRead)
+                .setDstStageMask(vk::PipelineStageFlagBits2::eDrawIndirect)
+                .setSrcQueueFamilyIndex(m_computeQueueFamily)
+                .setDstQueueFamilyIndex(m_graphicsQueueFamily)};
+        depInfo.setBufferMemoryBarriers(barriers);
+        cmdBuffer.pipelineBarrier2(depInfo);
+    }
+}
+
+void ApplicationBase::finalBlit(vk::CommandBuffer &cmdBuffer, FrameResources &frame)
 {
     // just a copy in order to pass compile
     vk::DeviceSize offset{0ULL};
     vk::Buffer vertexBuffer{*m_vertexBuffer};
     vk::Buffer indexBuffer{*m_indexBuffer};
-    vk::Buffer hiZVertexBuffer{*m_hiZOutputVertexBuffer};
 
-    if (m_renderingMode == eRenderingMode::RENDERING_MODE_SCANLINE_ZBUFFER)
+    bindDescriptorHeap(cmdBuffer, vk::PipelineBindPoint::eGraphics);
+    if (isScanlineMode())
     {
         cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_blitPipeline);
         cmdBuffer.setViewport(0, vk::Viewport(.0f, .0f, m_mainWindow.Width, m_mainWindow.Height, .0f, 1.f));
         cmdBuffer.setScissor(0, vk::Rect2D({}, {static_cast<uint32_t>(m_mainWindow.Width), static_cast<uint32_t>(m_mainWindow.Height)}));
-        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_blitPipelineLayout, 0, m_scanlineSet, {});
         cmdBuffer.draw(3, 1, 0, 0);
     }
-    else if (m_renderingMode >= eRenderingMode::RENDERING_MODE_NAIVE_HI_ZBUFFER)
+    else if (isVisibilityMode())
+    {
+        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_visibilityResolvePipeline);
+        cmdBuffer.setViewport(0, vk::Viewport(.0f, .0f, m_mainWindow.Width, m_mainWindow.Height, .0f, 1.f));
+        cmdBuffer.setScissor(0, vk::Rect2D({}, {static_cast<uint32_t>(m_mainWindow.Width), static_cast<uint32_t>(m_mainWindow.Height)}));
+        cmdBuffer.draw(3, 1, 0, 0);
+    }
+    else if (usePrepass())
     {
         cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_hiZBufferPostRenderPipeline);
         cmdBuffer.setViewport(0, vk::Viewport(.0f, .0f, m_mainWindow.Width, m_mainWindow.Height, .0f, 1.f));
         cmdBuffer.setScissor(0, vk::Rect2D({}, {static_cast<uint32_t>(m_mainWindow.Width), static_cast<uint32_t>(m_mainWindow.Height)}));
-        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_hiZBufferOutputPipelineLayout, 0, {m_geometrySet, m_zBufferSet, m_hiZOutputSet, m_octreeSet}, {});
-        cmdBuffer.bindVertexBuffers(0, hiZVertexBuffer, offset);
-        cmdBuffer.drawIndirect(*m_hiZIndirectRenderBuffer, offset, 1, sizeof(glm::uvec4));
+        // surviving faces index the model vertices, so primitive i of the draw is the face of indices 3i to 3i + 2 in the output
+        cmdBuffer.bindVertexBuffers(0, vertexBuffer, offset);
+        cmdBuffer.bindIndexBuffer(*frame.hiZOutputIndexBuffer, offset, vk::IndexType::eUint32);
+        cmdBuffer.drawIndexedIndirect(*frame.hiZIndirectRenderBuffer, offset, 1, sizeof(vk::DrawIndexedIndirectCommand));
     }
     else
     {
@@ -565,12 +1388,9 @@ void ApplicationBase::finalBlit(vk::CommandBuffer &cmdBuffer)
         {
         case eRenderingMode::RENDERING_MODE_DEFAULT_WIREFRAME:
             cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_defaultFramePipeline);
-            cmdBuffer.pushConstants(m_defaultPipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0ULL, sizeof(PushConstants), &m_pushConstants);
             break;
         case eRenderingMode::RENDERING_MODE_NAIVE_ZBUFFER:
             cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_naiveZBufferPipeline);
-            cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_naiveZBufferPipelineLayout, 0, {m_geometrySet, m_zBufferSet}, {});
-            cmdBuffer.pushConstants(m_naiveZBufferPipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0ULL, sizeof(PushConstants), &m_pushConstants);
             break;
         default:
             break;
@@ -582,4 +1402,20 @@ void ApplicationBase::finalBlit(vk::CommandBuffer &cmdBuffer)
         cmdBuffer.bindIndexBuffer(indexBuffer, offset, vk::IndexType::eUint32);
         cmdBuffer.drawIndexed(m_triangleCount * 3, 1, 0, 0, 0);
     }
-}
\ No newline at end of file
+}
+
+void ApplicationBase::updateProfileResults(FrameResources &frame)
+{
+    frame.profiler.resolve();
+    const auto &results = frame.profiler.getResults();
+    if (results.empty())
+        return;
+
+    // async compute of this frame against graphics post work (blit & ui) of the frame before
+    m_asyncComputeOverlapMs = .0;
+    if (const auto *compute = frame.profiler.findResult("async compute"); compute && m_lastGraphicsSection.endNs > .0)
+        m_asyncComputeOverlapMs = std::max(.0, std::min(compute->endNs, m_lastGraphicsSection.endNs) - std::max(compute->beginNs, m_lastGraphicsSection.beginNs)) * 1e-6;
+    if (const auto *graphics = frame.profiler.findResult("graphics post"); graphics)
+        m_lastGraphicsSection = *graphics;
+    m_profileResults = results;
+}
@@ -8,7 +8,6 @@ void ApplicationBase::newFrame(SDL_Window *windowHandle)
     {
         SDL_GetWindowSize(windowHandle, &m_mainWindow.Width, &m_mainWindow.Height);
         m_size = vk::Extent2D{static_cast<uint32_t>(m_mainWindow.Width), static_cast<uint32_t>(m_mainWindow.Height)};
-        recreateRenderTargets();
         m_mainCamera.setWindowSize(m_mainWindow.Width, m_mainWindow.Height);
         if (m_size.width > 0 && m_size.height > 0)
         {
@@ -56,58 +55,172 @@ void ApplicationBase::presentFrame()
 // i am not sure what caused the issue
 void ApplicationBase::renderFrame()
 {
+    auto &frame = m_frames[m_frameIndex];
     vk::SwapchainKHR swapchain = m_mainWindow.Swapchain;
     vk::Semaphore acquireSemaphore = m_mainWindow.FrameSemaphores[m_mainWindow.SemaphoreIndex].ImageAcquiredSemaphore;
     vk::Semaphore waitSemaphore = m_mainWindow.FrameSemaphores[m_mainWindow.SemaphoreIndex].RenderCompleteSemaphore;
-    vk::ClearValue clearValue = vk::ClearColorValue{.0f, .0f, .0f, 1.f};
+
+    // wait the GPU finishing the last frame which used the same resources
+    // other frames in flight keep running meanwhile
+    m_renderContext.getDeviceHandle()->waitForFences(frame.inFlightFence, VK_TRUE, UINT64_MAX);
 
     auto [status, res] = m_renderContext.getDeviceHandle()->acquireNextImageKHR(swapchain, UINT64_MAX, acquireSemaphore, {});
     m_mainWindow.FrameIndex = res;
     assert(status >= vk::Result::eSuccess);
     if (status == vk::Result::eErrorOutOfDateKHR || status == vk::Result::eSuboptimalKHR)
     {
+        // fence is kept signaled since nothing will be submitted
         m_swapchainDirty = true;
         return;
     }
+    m_renderContext.getDeviceHandle()->resetFences(frame.inFlightFence);
+    submitFrame(frame, m_mainWindow.Frames[m_mainWindow.FrameIndex].Framebuffer, acquireSemaphore, waitSemaphore);
+}
 
-    vk::CommandBuffer currentCmdBuffer = m_mainWindow.Frames[m_mainWindow.FrameIndex].CommandBuffer;
-    vk::Fence fence = m_mainWindow.Frames[m_mainWindow.FrameIndex].Fence;
-
-    // wait last frame for completing presenting
-    m_renderContext.getDeviceHandle()->waitForFences(fence, VK_TRUE, UINT64_MAX);
-    m_renderContext.getDeviceHandle()->resetFences(fence);
-
-    // begin internal command buffer
-    vk::CommandPool pool = m_mainWindow.Frames[m_mainWindow.FrameIndex].CommandPool;
-    m_renderContext.getDeviceHandle()->resetCommandPool(pool);
-    currentCmdBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+// records and submits every command of a frame whose fence has been waited and reset
+// semaphores are optional, headless rendering neither acquires nor presents
+void ApplicationBase::submitFrame(FrameResources &frame, vk::Framebuffer frameBuffer, vk::Semaphore acquireSemaphore, vk::Semaphore renderCompleteSemaphore)
+{
+    vk::ClearValue clearValue = vk::ClearColorValue{.0f, .0f, .0f, 1.f};
+    updateProfileResults(frame);
+    updateRenderTargets(frame);
+    // previous submission of this frame has finished, so its transient images can be replaced
+    // temporal hi-z also imports the z-buffer of the previous frame, which may have gained or lost its history meanwhile
+    if (frame.graphDirty || frame.graphMode != m_renderingMode ||
+        (m_renderingMode == eRenderingMode::RENDERING_MODE_TEMPORAL_HI_ZBUFFER && frame.historyZBuffer != getTemporalHistory(frame)))
+        buildFrameGraphs(frame);
+    updateRootData(frame);
+    for (const auto *context : {&frame.prepass, &frame.compute, &frame.post, &frame.scene, &frame.ui})
+        m_renderContext.getDeviceHandle()->resetCommandPool(context->pool);
+    m_pushConstants.imageHeapBase = frame.imageHeapBase;
+    m_pushConstants.bufferHeapBase = frame.bufferHeapBase;
+    m_pushConstants.rootAddress = frame.rootBuffer->getDeviceAddress();
 
-    render(currentCmdBuffer);
+    // command buffers are independent of each other, so they are recorded in parallel
+    // while submission below keeps the order of prepass -> compute -> post
+    std::future<void> prepassRecorded{};
+    std::future<void> computeRecorded{};
+    // graphics work feeding compute, e.g. z prepass of hi-z
+    if (usePrepass())
+        prepassRecorded = m_recordingThreads.submit([&]()
+                                                    {
+            frame.prepass.cmdBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+            renderPrepass(frame.prepass.cmdBuffer, frame);
+            frame.prepass.cmdBuffer.end(); });
+    // compute stages run on async compute queue, overlapping the graphics work of previous frame
+    if (useAsyncCompute())
+        computeRecorded = m_recordingThreads.submit([&]()
+                                                    {
+            frame.compute.cmdBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+            render(frame.compute.cmdBuffer, frame);
+            frame.compute.cmdBuffer.end(); });
 
     vk::RenderPass pass = m_mainWindow.RenderPass;
-    vk::Framebuffer frameBuffer = m_mainWindow.Frames[m_mainWindow.FrameIndex].Framebuffer;
-    vk::Rect2D rect{{}, {static_cast<uint32_t>(m_mainWindow.Width), static_cast<uint32_t>(m_mainWindow.Height)}};
+    vk::Rect2D rect{{}, m_size};
     vk::RenderPassBeginInfo beginInfo{};
     beginInfo.setRenderPass(pass)
         .setFramebuffer(frameBuffer)
         .setRenderArea(rect)
         .setClearValues(clearValue);
-    currentCmdBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+    recordPost(frame, beginInfo);
 
-    finalBlit(currentCmdBuffer);
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), currentCmdBuffer);
+    if (prepassRecorded.valid())
+    {
+        prepassRecorded.get();
+        vk::SubmitInfo submitInfo{};
+        submitInfo.setCommandBuffers(frame.prepass.cmdBuffer)
+            .setSignalSemaphores(frame.prepassFinishedSemaphore);
+        m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eGraphics)->queue_handle->submit(submitInfo);
+    }
 
-    currentCmdBuffer.endRenderPass();
-    currentCmdBuffer.end();
+    if (computeRecorded.valid())
+    {
+        computeRecorded.get();
+        vk::PipelineStageFlags stageFlag{vk::PipelineStageFlagBits::eComputeShader};
+        vk::SubmitInfo submitInfo{};
+        submitInfo.setCommandBuffers(frame.compute.cmdBuffer)
+            .setSignalSemaphores(frame.computeFinishedSemaphore);
+        if (usePrepass())
+            submitInfo.setWaitDstStageMask(stageFlag)
+                .setWaitSemaphores(frame.prepassFinishedSemaphore);
+        m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eCompute, false)->queue_handle->submit(submitInfo);
+    }
 
-    vk::PipelineStageFlags stageFlag{vk::PipelineStageFlagBits::eColorAttachmentOutput};
+    std::vector<vk::Semaphore> waitSemaphores{};
+    std::vector<vk::PipelineStageFlags> stageFlags{};
+    if (acquireSemaphore)
+    {
+        waitSemaphores.emplace_back(acquireSemaphore);
+        stageFlags.emplace_back(vk::PipelineStageFlagBits::eColorAttachmentOutput);
+    }
+    if (useAsyncCompute())
+    {
+        waitSemaphores.emplace_back(frame.computeFinishedSemaphore);
+        stageFlags.emplace_back(vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eFragmentShader);
+    }
+    else if (usePrepass())
+    {
+        // prepass feeds post directly, e.g. visibility buffer and temporal hi-z
+        waitSemaphores.emplace_back(frame.prepassFinishedSemaphore);
+        stageFlags.emplace_back(vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eFragmentShader);
+    }
     vk::SubmitInfo submitInfo{};
-    submitInfo.setCommandBuffers(currentCmdBuffer)
-        .setWaitDstStageMask(stageFlag)
-        .setWaitSemaphores(acquireSemaphore)
-        .setSignalSemaphores(waitSemaphore);
-    m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eGraphics)->queue_handle->submit(submitInfo, fence);
-    // m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eGraphics)->queue_handle->waitIdle();
+    submitInfo.setCommandBuffers(frame.post.cmdBuffer)
+        .setWaitDstStageMask(stageFlags)
+        .setWaitSemaphores(waitSemaphores);
+    if (renderCompleteSemaphore)
+        submitInfo.setSignalSemaphores(renderCompleteSemaphore);
+    m_renderContext.getQueueInstanceHandle(vk::QueueFlagBits::eGraphics)->queue_handle->submit(submitInfo, frame.inFlightFence);
+
+    m_frameIndex = (m_frameIndex + 1) % g_maxFramesInFlight;
+}
+
+// scene and ui are recorded into secondary command buffers on worker threads,
+// while the primary records the work outside of the render pass
+void ApplicationBase::recordPost(FrameResources &frame, const vk::RenderPassBeginInfo &beginInfo)
+{
+    vk::CommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.setRenderPass(beginInfo.renderPass)
+        .setSubpass(0U)
+        .setFramebuffer(beginInfo.framebuffer);
+    vk::CommandBufferBeginInfo secondaryBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritanceInfo};
+    auto sceneRecorded = m_recordingThreads.submit([&]()
+                                                   {
+        frame.scene.cmdBuffer.begin(secondaryBeginInfo);
+        finalBlit(frame.scene.cmdBuffer, frame);
+        frame.scene.cmdBuffer.end(); });
+    std::future<void> uiRecorded{};
+    if (!m_headless)
+        uiRecorded = m_recordingThreads.submit([&]()
+                                               {
+            frame.ui.cmdBuffer.begin(secondaryBeginInfo);
+            ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), frame.ui.cmdBuffer);
+            frame.ui.cmdBuffer.end(); });
+
+    vk::CommandBuffer cmdBuffer = frame.post.cmdBuffer;
+    cmdBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    const auto section = frame.profiler.beginSection(cmdBuffer, "graphics post");
+
+    if (!usePrepass())
+        clearZBuffer(cmdBuffer, frame);
+    if (useAsyncCompute())
+        acquireComputeResults(cmdBuffer, frame);
+
+    cmdBuffer.beginRenderPass(beginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+    sceneRecorded.get();
+    if (uiRecorded.valid())
+    {
+        uiRecorded.get();
+        cmdBuffer.executeCommands({frame.scene.cmdBuffer, frame.ui.cmdBuffer});
+    }
+    else
+        cmdBuffer.executeCommands(frame.scene.cmdBuffer);
+    cmdBuffer.endRenderPass();
+    if (m_headless)
+        recordReadback(cmdBuffer);
+
+    frame.profiler.endSection(cmdBuffer, section);
+    cmdBuffer.end();
 }
 
 void ApplicationBase::destroy()
@@ -119,61 +232,84 @@ void ApplicationBase::destroy()
 
     ImGui_ImplVulkanH_DestroyWindow(*m_renderContext.getInstanceHandle(), *m_renderContext.getDeviceHandle(),
                                     &m_mainWindow, reinterpret_cast<VkAllocationCallbacks *>(&allocationCallbacks));
+    destroyRenderer();
+}
+
+// everything created by createRenderer(), shared by windowed and headless front ends
+void ApplicationBase::destroyRenderer()
+{
+    m_renderContext.getDeviceHandle()->waitIdle();
 
     m_vertexBuffer.reset();
     m_indexBuffer.reset();
-    m_scanlineBuffer.reset();
-    m_scanlineGlobalPropertyBuffer.reset();
-    m_hiZOutputVertexBuffer.reset();
-    m_hiZIndirectRenderBuffer.reset();
-    m_faceIndicesOfOctree.reset();
-    m_zBuffer.reset();
-    for (auto i = 0; i < m_zBufferMipViews.size(); ++i)
-        if (m_zBufferMipViews[i])
-            m_renderContext.getDeviceHandle()->destroy(m_zBufferMipViews[i], allocationCallbacks);
-    m_octreeLinkHeader.reset();
-    for (auto i = 0; i < m_octreeLinkHeaderMipViews.size(); ++i)
-        if (m_octreeLinkHeaderMipViews[i])
-            m_renderContext.getDeviceHandle()->destroy(m_octreeLinkHeaderMipViews[i], allocationCallbacks);
-    m_octreeMarker.reset();
-    for (auto i = 0; i < m_octreeMarkerMipViews.size(); ++i)
-        if (m_octreeMarkerMipViews[i])
-            m_renderContext.getDeviceHandle()->destroy(m_octreeMarkerMipViews[i], allocationCallbacks);
-    m_colorBuffer.reset();
-    m_renderContext.getDeviceHandle()->destroy(m_colorBufferView, allocationCallbacks);
-    m_scanlineBufferSpinlock.reset();
-    m_renderContext.getDeviceHandle()->destroy(m_scanlineBufferSpinlockView, allocationCallbacks);
-    m_emptyBuffer.reset();
-    m_renderContext.getDeviceHandle()->destroy(m_emptyBufferView, allocationCallbacks);
+    m_clusterBuffer.reset();
+    m_octreeNodeBuffer.reset();
+    m_octreeFaceBuffer.reset();
+    for (auto &frame : m_frames)
+    {
+        destroyRenderTargets(frame);
+        frame.scanlineBuffer.reset();
+        frame.scanlineTileEntries.reset();
+        frame.scanlineSegmentOffsets.reset();
+        for (auto &sortPairs : frame.scanlineSortPairs)
+            sortPairs.reset();
+        frame.scanlineSortHistogram.reset();
+        frame.scanlineGlobalPropertyBuffer.reset();
+        frame.hiZOutputIndexBuffer.reset();
+        frame.hiZIndirectRenderBuffer.reset();
+        frame.octreeQueues.reset();
+        frame.lbvhNodes.reset();
+        frame.lbvhQueues.reset();
+        frame.hiZRejectedFaces.reset();
+        frame.hiZVisibleClusters.reset();
+        frame.rootBuffer.reset();
+        m_renderContext.getDeviceHandle()->destroy(frame.prepassFinishedSemaphore, allocationCallbacks);
+        m_renderContext.getDeviceHandle()->destroy(frame.computeFinishedSemaphore, allocationCallbacks);
+        m_renderContext.getDeviceHandle()->destroy(frame.inFlightFence, allocationCallbacks);
+        for (const auto *context : {&frame.prepass, &frame.compute, &frame.post, &frame.scene, &frame.ui})
+            m_renderContext.getDeviceHandle()->destroy(context->pool, allocationCallbacks);
+        frame.profiler.destroy();
+    }
 
     m_renderContext.getDeviceHandle()->destroy(m_guiDescPool, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_defaultPipelineLayout, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_defaultFramePipeline, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_naiveZBufferPipelineLayout, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_naiveZBufferPipeline, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_scanlineZBufferPipelineLayout, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_scanlineZBufferInitPipeline, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_scanlineZBufferWorkPipeline, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_zPrepassPipelinelayout, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_scanlineSegmentScanPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_radixSortHistogramPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_radixSortScanPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_radixSortScatterPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_scanlinePainterFillPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_scanlineTileCountPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_scanlineTileScanPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_scanlineTileScatterPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_scanlineTileResolvePipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_scanlinePackedWorkPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_scanlinePackedResolvePipeline, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_zPrepassPipeline, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_zBufferMipMappingPipelineLayout, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_zBufferMipMappingPipeline, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_octreeInitPipelineLayout, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_octreeInitPipeline, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_hiZBufferOutputPipelineLayout, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_hiZClusterCullingPipeline, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_naiveHiZBufferWorkPipeline, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_optimHiZBufferWorkPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_octreeLeafCullingPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_lbvhMortonPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_lbvhHierarchyPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_lbvhRefitPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_lbvhFrontierPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_lbvhSubtreePipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_temporalHiZCullingPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_temporalHiZRecheckPipeline, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_hiZBufferPostRenderPipeline, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_blitPipelineLayout, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_blitPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_visibilityRasterPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_hybridRasterPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_visibilityHybridRasterPipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_visibilityResolvePipeline, allocationCallbacks);
+    m_renderContext.getDeviceHandle()->destroy(m_pipelineLayout, allocationCallbacks);
 
-    m_renderContext.getDeviceHandle()->resetDescriptorPool(m_descPool);
-    m_renderContext.getDeviceHandle()->destroy(m_descPool, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_zBufferSetLayout, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_geometrySetLayout, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_scanlineSetLayout, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_hiZOutputSetLayout, allocationCallbacks);
-    m_renderContext.getDeviceHandle()->destroy(m_octreeSetLayout, allocationCallbacks);
+    m_targetPool.destroy();
+    m_descriptorHeap.destroy();
 
     m_renderContext.getDeviceHandle()->destroy(m_internalTransferFence, allocationCallbacks);
     m_renderContext.getDeviceHandle()->destroy(m_internalTransferPool, allocationCallbacks);
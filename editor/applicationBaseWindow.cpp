@@ -19,7 +19,7 @@ void ApplicationBase::initSurface(SDL_Window *windowHandle)
     SDL_Vulkan_GetInstanceExtensions(windowHandle, &extensionCount, nullptr);
     instanceExtensions.resize(extensionCount);
     SDL_Vulkan_GetInstanceExtensions(windowHandle, &extensionCount, instanceExtensions.data());
-    m_renderContext.init(instanceExtensions, {}, {VK_EXT_FRAGMENT_SHADER_INTERLOCK_EXTENSION_NAME}, {});
+    m_renderContext.init(instanceExtensions, {}, {}, {}, g_optionalDeviceExtensions);
 
     if (SDL_Vulkan_CreateSurface(windowHandle, *m_renderContext.getInstanceHandle(), &m_mainWindow.Surface) == SDL_FALSE)
     {
@@ -36,7 +36,11 @@ void ApplicationBase::initSurface(SDL_Window *windowHandle)
     m_frequency = SDL_GetPerformanceFrequency();
     m_prevCounter = SDL_GetPerformanceCounter();
 
-    // init camera property
+    initCamera();
+}
+
+void ApplicationBase::initCamera()
+{
     m_mainCamera.setLookat({-1.f, .0f, .0f}, {.0f, .0f, .0f}, {.0f, 1.f, .0f});
     m_mainCamera.setWindowSize(m_mainWindow.Width, m_mainWindow.Height);
     m_mainCamera.setClipPlanes({.01f, 1000.f});
@@ -120,11 +124,31 @@ void ApplicationBase::displayGui(SDL_Window *windowHandle)
 
     ImGui::Begin("settings");
 
-    ImGui::Combo("rendering mode", (int *)&m_renderingMode, g_renderingModeText, 5);
+    if (ImGui::BeginCombo("rendering mode", g_renderingModeText[m_renderingMode]))
+    {
+        // modes missing an optional device feature stay listed but cannot be picked
+        for (int i = 0; i < std::size(g_renderingModeText); ++i)
+        {
+            const auto mode = static_cast<eRenderingMode>(i);
+            if (ImGui::Selectable(g_renderingModeText[i], m_renderingMode == mode, isModeSupported(mode) ? ImGuiSelectableFlags_None : ImGuiSelectableFlags_Disabled))
+                m_renderingMode = mode;
+        }
+        ImGui::EndCombo();
+    }
     ImGui::InputFloat3("light direction", &m_pushConstants.lightDirection.x);
     ImGui::TextWrapped("vertex count: %llu", m_vertexCount);
     ImGui::TextWrapped("Triangle face count: %llu", m_triangleCount);
 
+    if (ImGui::CollapsingHeader("gpu timings"))
+    {
+        for (const auto &section : m_profileResults)
+            ImGui::TextWrapped("%s: %.3fms", section.name.c_str(), section.durationMs());
+        if (m_graphicsQueueFamily != m_computeQueueFamily)
+            ImGui::TextWrapped("async compute overlapped with last frame: %.3fms", m_asyncComputeOverlapMs);
+        else
+            ImGui::TextWrapped("no dedicated compute queue family, compute runs on graphics queue");
+    }
+
     ImGui::End();
 }
 
@@ -66,6 +66,24 @@ static inline vk::ImageMemoryBarrier2 makeImageMemoryBarrier(vk::Image img,
     return barrier;
 }
 
+static inline vk::BufferMemoryBarrier2 makeBufferMemoryBarrier(vk::Buffer buffer,
+                                                               vk::AccessFlags2 srcAccess,
+                                                               vk::AccessFlags2 dstAccess,
+                                                               vk::DeviceSize offset = 0ULL,
+                                                               vk::DeviceSize size = VK_WHOLE_SIZE)
+{
+    vk::BufferMemoryBarrier2 barrier{};
+    barrier.setSrcAccessMask(srcAccess)
+        .setDstAccessMask(dstAccess)
+        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+        .setBuffer(buffer)
+        .setOffset(offset)
+        .setSize(size);
+
+    return barrier;
+}
+
 static inline void cmdBarrierImageLayout(vk::CommandBuffer cmdbuffer,
                                          vk::Image image,
                                          vk::ImageLayout oldImageLayout,
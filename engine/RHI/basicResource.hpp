@@ -29,6 +29,12 @@ public:
         m_memAllocator->unmap(m_memHandle);
     }
 
+    // requires the buffer to be created with eShaderDeviceAddress usage
+    vk::DeviceAddress getDeviceAddress() const
+    {
+        return m_deviceHandle->getBufferAddress(vk::BufferDeviceAddressInfo{m_buffer});
+    }
+
     operator vk::Buffer() const { return m_buffer; }
     operator MemoryHandle() const { return m_memHandle; }
 
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <vector>
+
+#include "allocationCallbacks.h"
+
+// a single descriptor set holding large partially bound arrays of storage images and storage buffers
+// resources are written into fixed slots once and referenced by index from shaders,
+// so every pipeline can share one layout and the set never needs rebinding
+// slots may be rewritten after the set is bound (update-after-bind), but not while a pending command buffer reads them
+class DescriptorHeap
+{
+public:
+    static constexpr uint32_t storageImageBinding = 0U;
+    static constexpr uint32_t storageBufferBinding = 1U;
+
+    DescriptorHeap(DescriptorHeap const &) = delete;
+    DescriptorHeap &operator=(DescriptorHeap const &) = delete;
+
+    DescriptorHeap() {}
+    ~DescriptorHeap() { destroy(); }
+
+    void init(std::shared_ptr<vk::Device> device, uint32_t maxStorageImageCount, uint32_t maxStorageBufferCount)
+    {
+        m_deviceHandle = device;
+        m_maxStorageImageCount = maxStorageImageCount;
+        m_maxStorageBufferCount = maxStorageBufferCount;
+
+        std::vector<vk::DescriptorPoolSize> poolSizes;
+        poolSizes.emplace_back(vk::DescriptorType::eStorageImage, m_maxStorageImageCount);
+        poolSizes.emplace_back(vk::DescriptorType::eStorageBuffer, m_maxStorageBufferCount);
+        vk::DescriptorPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind)
+            .setMaxSets(1U)
+            .setPoolSizes(poolSizes);
+        m_pool = m_deviceHandle->createDescriptorPool(poolCreateInfo, allocationCallbacks);
+
+        std::vector<vk::DescriptorSetLayoutBinding> bindings{};
+        bindings.emplace_back(storageImageBinding, vk::DescriptorType::eStorageImage, m_maxStorageImageCount, vk::ShaderStageFlagBits::eAll);
+        bindings.emplace_back(storageBufferBinding, vk::DescriptorType::eStorageBuffer, m_maxStorageBufferCount, vk::ShaderStageFlagBits::eAll);
+        // frames in flight rewrite their own slots while another frame's command buffers are pending
+        std::vector<vk::DescriptorBindingFlags> bindingFlags(bindings.size(), vk::DescriptorBindingFlagBits::eUpdateAfterBind | vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending | vk::DescriptorBindingFlagBits::ePartiallyBound);
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo{};
+        bindingFlagsCreateInfo.setBindingFlags(bindingFlags);
+        vk::DescriptorSetLayoutCreateInfo layoutCreateInfo{};
+        layoutCreateInfo.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool)
+            .setBindings(bindings)
+            .setPNext(&bindingFlagsCreateInfo);
+        m_layout = m_deviceHandle->createDescriptorSetLayout(layoutCreateInfo, allocationCallbacks);
+
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.setDescriptorPool(m_pool).setSetLayouts(m_layout);
+        m_set = m_deviceHandle->allocateDescriptorSets(allocInfo).front();
+    }
+
+    void destroy()
+    {
+        if (!m_deviceHandle)
+            return;
+
+        m_deviceHandle->destroy(m_pool, allocationCallbacks);
+        m_deviceHandle->destroy(m_layout, allocationCallbacks);
+        m_deviceHandle.reset();
+        m_pendingImages.clear();
+        m_pendingBuffers.clear();
+    }
+
+    // writes are batched until flush()
+    void setStorageImage(uint32_t slot, vk::ImageView view, vk::ImageLayout layout = vk::ImageLayout::eGeneral)
+    {
+        assert(slot < m_maxStorageImageCount);
+        m_pendingImages.push_back({slot, vk::DescriptorImageInfo{vk::Sampler{}, view, layout}});
+    }
+
+    void setStorageBuffer(uint32_t slot, vk::Buffer buffer, vk::DeviceSize offset = 0ULL, vk::DeviceSize range = VK_WHOLE_SIZE)
+    {
+        assert(slot < m_maxStorageBufferCount);
+        m_pendingBuffers.push_back({slot, vk::DescriptorBufferInfo{buffer, offset, range}});
+    }
+
+    void flush()
+    {
+        if (m_pendingImages.empty() && m_pendingBuffers.empty())
+            return;
+
+        std::vector<vk::WriteDescriptorSet> writeDescs{};
+        writeDescs.reserve(m_pendingImages.size() + m_pendingBuffers.size());
+        for (const auto &[slot, info] : m_pendingImages)
+            writeDescs.emplace_back(m_set, storageImageBinding, slot, vk::DescriptorType::eStorageImage, info);
+        for (const auto &[slot, info] : m_pendingBuffers)
+            writeDescs.emplace_back(m_set, storageBufferBinding, slot, vk::DescriptorType::eStorageBuffer, nullptr, info);
+        m_deviceHandle->updateDescriptorSets(writeDescs, {});
+
+        m_pendingImages.clear();
+        m_pendingBuffers.clear();
+    }
+
+    vk::DescriptorSetLayout getLayout() const noexcept { return m_layout; }
+    vk::DescriptorSet getSet() const noexcept { return m_set; }
+
+private:
+    template <typename T>
+    struct PendingWrite
+    {
+        uint32_t slot;
+        T info;
+    };
+
+    std::shared_ptr<vk::Device> m_deviceHandle;
+    vk::DescriptorPool m_pool{};
+    vk::DescriptorSetLayout m_layout{};
+    vk::DescriptorSet m_set{};
+    uint32_t m_maxStorageImageCount{0U};
+    uint32_t m_maxStorageBufferCount{0U};
+
+    std::vector<PendingWrite<vk::DescriptorImageInfo>> m_pendingImages{};
+    std::vector<PendingWrite<vk::DescriptorBufferInfo>> m_pendingBuffers{};
+};
@@ -13,4 +13,6 @@
 // #include "stagingHelper.hpp"
 #include "memoryAllocator.hpp"
 // #include "resourceAllocator.hpp"
-#include "basicResource.hpp"
\ No newline at end of file
+#include "basicResource.hpp"
+#include "timestampProfiler.hpp"
+#include "descriptorHeap.hpp"
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "allocationCallbacks.h"
+
+// gpu profiler based on timestamp queries
+// every section owns a pair of queries (begin & end), results are read back once the owner's fence has been waited
+// NOTICE: comparing timestamps written by different queues assumes that they share the same time domain,
+// which holds on common desktop drivers but is not guaranteed by the spec
+class TimestampProfiler
+{
+public:
+    struct Section
+    {
+        std::string name{};
+        double beginNs{.0};
+        double endNs{.0};
+
+        double durationMs() const { return (endNs - beginNs) * 1e-6; }
+    };
+
+    TimestampProfiler(TimestampProfiler const &) = delete;
+    TimestampProfiler &operator=(TimestampProfiler const &) = delete;
+
+    TimestampProfiler() {}
+    ~TimestampProfiler() { destroy(); }
+
+    void init(std::shared_ptr<vk::Device> device, const vk::PhysicalDevice &adapter, uint32_t maxSectionCount = 16U)
+    {
+        m_deviceHandle = device;
+        m_timestampPeriod = adapter.getProperties().limits.timestampPeriod;
+        m_maxSectionCount = maxSectionCount;
+
+        vk::QueryPoolCreateInfo createInfo{};
+        createInfo.setQueryType(vk::QueryType::eTimestamp)
+            .setQueryCount(2U * m_maxSectionCount);
+        m_queryPool = m_deviceHandle->createQueryPool(createInfo, allocationCallbacks);
+        m_deviceHandle->resetQueryPool(m_queryPool, 0U, 2U * m_maxSectionCount);
+    }
+
+    void destroy()
+    {
+        if (!m_deviceHandle)
+            return;
+
+        m_deviceHandle->destroyQueryPool(m_queryPool, allocationCallbacks);
+        m_deviceHandle.reset();
+        m_pendingNames.clear();
+        m_results.clear();
+    }
+
+    // read back the sections recorded last time and reset queries on host (needs hostQueryReset)
+    // must be called after the fence guarding all recorded command buffers has been waited
+    void resolve()
+    {
+        if (m_pendingNames.empty())
+            return;
+
+        std::vector<uint64_t> timestamps(2U * m_pendingNames.size());
+        auto res = m_deviceHandle->getQueryPoolResults(m_queryPool, 0U, static_cast<uint32_t>(timestamps.size()),
+                                                       timestamps.size() * sizeof(uint64_t), timestamps.data(),
+                                                       sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+        m_results.clear();
+        if (res == vk::Result::eSuccess)
+        {
+            m_results.reserve(m_pendingNames.size());
+            for (auto i = 0; i < m_pendingNames.size(); ++i)
+                m_results.push_back({m_pendingNames[i], timestamps[2 * i] * m_timestampPeriod, timestamps[2 * i + 1] * m_timestampPeriod});
+        }
+
+        m_deviceHandle->resetQueryPool(m_queryPool, 0U, 2U * static_cast<uint32_t>(m_pendingNames.size()));
+        m_pendingNames.clear();
+    }
+
+    // returns ~0U when the pool is exhausted, such section is ignored by endSection()
+    // thread safe, so command buffers of one frame may be recorded in parallel
+    uint32_t beginSection(vk::CommandBuffer &cmdBuffer, const std::string &name, vk::PipelineStageFlagBits2 stage = vk::PipelineStageFlagBits2::eTopOfPipe)
+    {
+        uint32_t section{};
+        {
+            std::lock_guard lock(m_sectionMutex);
+            if (m_pendingNames.size() >= m_maxSectionCount)
+                return ~0U;
+
+            section = static_cast<uint32_t>(m_pendingNames.size());
+            m_pendingNames.emplace_back(name);
+        }
+        cmdBuffer.writeTimestamp2(stage, m_queryPool, 2U * section);
+        return section;
+    }
+
+    void endSection(vk::CommandBuffer &cmdBuffer, uint32_t section, vk::PipelineStageFlagBits2 stage = vk::PipelineStageFlagBits2::eBottomOfPipe)
+    {
+        if (section == ~0U)
+            return;
+
+        cmdBuffer.writeTimestamp2(stage, m_queryPool, 2U * section + 1U);
+    }
+
+    const std::vector<Section> &getResults() const { return m_results; }
+
+    const Section *findResult(const std::string &name) const
+    {
+        for (const auto &section : m_results)
+            if (section.name == name)
+                return &section;
+        return nullptr;
+    }
+
+private:
+    std::shared_ptr<vk::Device> m_deviceHandle;
+    vk::QueryPool m_queryPool{};
+    float m_timestampPeriod{1.f};
+    uint32_t m_maxSectionCount{0U};
+
+    std::mutex m_sectionMutex{};
+    std::vector<std::string> m_pendingNames{};
+    std::vector<Section> m_results{};
+};
@@ -4,5 +4,5 @@
 #endif
 #endif
 #define VMA_IMPLEMENTATION
-#define VMA_BUFFER_DEVICE_ADDRESS 0
+#define VMA_BUFFER_DEVICE_ADDRESS 1
 #include <vma/vk_mem_alloc.h>
\ No newline at end of file
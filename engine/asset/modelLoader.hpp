@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <thread>
+
 #include <rapidobj.hpp>
 #include <spdlog/spdlog.h>
 
@@ -124,4 +128,185 @@ inline auto loadModel(const std::filesystem::path &filePath)
     }
 
     return std::tuple{vertices, indices, box};
-}
\ No newline at end of file
+}
+
+// bounds of consecutive faces, which mostly are neighbours since faces keep the order of the file
+struct FaceCluster
+{
+    glm::vec4 minPoint; // w unused
+    glm::vec4 maxPoint;
+    glm::vec4 cone; // average normal & sine of the largest angle to it, w above 1 when no side of the cluster is back facing as a whole
+};
+
+inline auto buildFaceClusters(const std::vector<glm::vec4> &vertices, const std::vector<uint32_t> &indices, uint32_t clusterSize)
+{
+    const size_t triangleCount = indices.size() / 3;
+    std::vector<FaceCluster> clusters((triangleCount + clusterSize - 1) / clusterSize);
+    std::vector<glm::vec3> normals(clusterSize);
+    for (size_t i = 0; i < clusters.size(); ++i)
+    {
+        const size_t firstFace = i * clusterSize, faceCount = std::min<size_t>(clusterSize, triangleCount - firstFace);
+        BoundingBox box{vertices[indices[3 * firstFace]], vertices[indices[3 * firstFace]]};
+        glm::vec3 axis{.0f};
+        for (size_t j = 0; j < faceCount; ++j)
+        {
+            const glm::vec3 v0 = vertices[indices[3 * (firstFace + j) + 0]];
+            const glm::vec3 v1 = vertices[indices[3 * (firstFace + j) + 1]];
+            const glm::vec3 v2 = vertices[indices[3 * (firstFace + j) + 2]];
+            box.extend(v0);
+            box.extend(v1);
+            box.extend(v2);
+            // same winding as the shaders, degenerate faces are never drawn so they do not widen the cone
+            const glm::vec3 normal = glm::cross(v1 - v0, v2 - v1);
+            const float length = glm::length(normal);
+            normals[j] = length > .0f ? normal / length : glm::vec3{.0f};
+            axis += normals[j];
+        }
+
+        float cutoff = 2.f;
+        if (glm::length(axis) > .0f)
+        {
+            axis = glm::normalize(axis);
+            float minCosine = 1.f;
+            for (size_t j = 0; j < faceCount; ++j)
+                if (normals[j] != glm::vec3{.0f})
+                    minCosine = std::min(minCosine, glm::dot(axis, normals[j]));
+            // normals spreading over a hemisphere always have some face towards the camera
+            if (minCosine > .0f)
+                cutoff = std::sqrt(1.f - minCosine * minCosine);
+        }
+        clusters[i] = FaceCluster{glm::vec4{box.minPoint, 1.f}, glm::vec4{box.maxPoint, 1.f}, glm::vec4{axis, cutoff}};
+    }
+    return clusters;
+}
+
+// node of the object space octree over the faces, keep in sync with OctreeNode in rootBuffer.glsl
+struct FaceOctreeNode
+{
+    glm::vec4 minPoint; // bounds refit to the faces below the node, usually tighter than its octant
+    glm::vec4 maxPoint;
+    uint32_t firstChild; // children of a node are contiguous, and nodes are stored level by level
+    uint32_t childCount; // 0 for leaves
+    uint32_t firstFace;  // faces below a node are a contiguous range of the sorted faces
+    uint32_t faceCount;
+};
+
+struct FaceOctree
+{
+    std::vector<FaceOctreeNode> nodes;
+    std::vector<uint32_t> faces; // face indices sorted by the morton code of their centroid
+};
+
+// faces are sorted by the morton code of their centroid, so every octant at any level is a contiguous range of them
+// octants are split until they hold at most leafSize faces or maxDepth is reached, each face ends up in exactly one leaf
+inline auto buildFaceOctree(const std::vector<glm::vec4> &vertices, const std::vector<uint32_t> &indices, BoundingBox box, uint32_t leafSize, uint32_t maxDepth)
+{
+    const size_t triangleCount = indices.size() / 3;
+    FaceOctree octree{};
+
+    // morton code of up to 21 levels & face index, one sort orders both
+    std::vector<std::pair<uint64_t, uint32_t>> keys(triangleCount);
+    const glm::vec3 cellScale = float(1U << maxDepth) / glm::max(box.getExtent(), glm::vec3{1e-6f});
+    const auto computeKeys = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const glm::vec3 centroid = (glm::vec3{vertices[indices[3 * i + 0]]} + glm::vec3{vertices[indices[3 * i + 1]]} + glm::vec3{vertices[indices[3 * i + 2]]}) / 3.f;
+            const glm::uvec3 cell = glm::min(glm::uvec3{glm::max(centroid - box.minPoint, glm::vec3{.0f}) * cellScale}, glm::uvec3{(1U << maxDepth) - 1U});
+            uint64_t code = 0ULL;
+            for (uint32_t bit = maxDepth; bit-- > 0;)
+                code = (code << 3) | (((cell.z >> bit) & 1U) << 2) | (((cell.y >> bit) & 1U) << 1) | ((cell.x >> bit) & 1U);
+            keys[i] = {code, static_cast<uint32_t>(i)};
+        }
+        std::sort(keys.begin() + begin, keys.begin() + end);
+    };
+    const size_t concurrency = std::clamp<size_t>(triangleCount / 65536, 1ULL, std::max(std::thread::hardware_concurrency(), 1U));
+    const auto chunkBegin = [&](size_t chunk)
+    { return triangleCount * std::min(chunk, concurrency) / concurrency; };
+    std::vector<std::thread> threads;
+    threads.reserve(concurrency);
+    const auto joinThreads = [&threads]
+    {
+        for (auto &thread : threads)
+            thread.join();
+        threads.clear();
+    };
+    // every thread sorts the keys it computed, sorted chunks are then merged pairwise, each round in parallel
+    for (size_t i = 0; i < concurrency; ++i)
+        threads.emplace_back(computeKeys, chunkBegin(i), chunkBegin(i + 1));
+    joinThreads();
+    for (size_t width = 1; width < concurrency; width *= 2)
+    {
+        for (size_t i = 0; i + width < concurrency; i += 2 * width)
+            threads.emplace_back([&keys, first = chunkBegin(i), middle = chunkBegin(i + width), last = chunkBegin(i + 2 * width)]
+                                 { std::inplace_merge(keys.begin() + first, keys.begin() + middle, keys.begin() + last); });
+        joinThreads();
+    }
+    octree.faces.resize(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i)
+        octree.faces[i] = keys[i].second;
+
+    // breadth first, so that the children of a node are pushed next to each other
+    // serial, it only reads two keys per node and scans each level of sorted keys once
+    // a node splits at the first level where its faces differ, so chains of single child nodes are never stored
+    // and the node count follows the occupied, branching cells however deep the codes go
+    octree.nodes.push_back(FaceOctreeNode{{}, {}, 0U, 0U, 0U, static_cast<uint32_t>(triangleCount)});
+    for (size_t i = 0; i < octree.nodes.size(); ++i)
+    {
+        const uint32_t firstFace = octree.nodes[i].firstFace, lastFace = firstFace + octree.nodes[i].faceCount;
+        if (lastFace - firstFace <= leafSize)
+            continue;
+        // sorted keys share their prefix with the first & last ones, the highest differing bit picks the level
+        const uint64_t differing = keys[firstFace].first ^ keys[lastFace - 1].first;
+        if (differing == 0ULL)
+            continue;
+        const uint32_t shift = 3 * ((63 - std::countl_zero(differing)) / 3);
+        const auto firstChild = static_cast<uint32_t>(octree.nodes.size());
+        for (uint32_t begin = firstFace, end = firstFace; begin < lastFace; begin = end)
+        {
+            const uint64_t octant = (keys[begin].first >> shift) & 7ULL;
+            while (end < lastFace && ((keys[end].first >> shift) & 7ULL) == octant)
+                ++end;
+            octree.nodes.push_back(FaceOctreeNode{{}, {}, 0U, 0U, begin, end - begin});
+        }
+        octree.nodes[i].firstChild = firstChild;
+        octree.nodes[i].childCount = static_cast<uint32_t>(octree.nodes.size()) - firstChild;
+    }
+
+    // leaves are bounded by their faces, which touches every vertex, so nodes are split between the threads
+    const auto refitLeaves = [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto &node = octree.nodes[i];
+            if (node.childCount > 0)
+                continue;
+            BoundingBox bounds{box.maxPoint, box.minPoint};
+            for (uint32_t j = 0; j < node.faceCount; ++j)
+                for (uint32_t k = 0; k < 3; ++k)
+                    bounds.extend(glm::vec3{vertices[indices[3 * octree.faces[node.firstFace + j] + k]]});
+            // an empty model still gets a root, bounded by the whole box
+            if (node.faceCount == 0)
+                bounds = box;
+            node.minPoint = glm::vec4{bounds.minPoint, 1.f};
+            node.maxPoint = glm::vec4{bounds.maxPoint, 1.f};
+        }
+    };
+    for (size_t i = 0; i < concurrency; ++i)
+        threads.emplace_back(refitLeaves, octree.nodes.size() * i / concurrency, octree.nodes.size() * (i + 1) / concurrency);
+    joinThreads();
+
+    // children come after their parent, so a backward sweep refits every inner node from finished children
+    for (size_t i = octree.nodes.size(); i-- > 0;)
+    {
+        auto &node = octree.nodes[i];
+        if (node.childCount == 0)
+            continue;
+        BoundingBox bounds{box.maxPoint, box.minPoint};
+        for (uint32_t j = 0; j < node.childCount; ++j)
+            bounds.extend(BoundingBox{octree.nodes[node.firstChild + j].minPoint, octree.nodes[node.firstChild + j].maxPoint});
+        node.minPoint = glm::vec4{bounds.minPoint, 1.f};
+        node.maxPoint = glm::vec4{bounds.maxPoint, 1.f};
+    }
+    return octree;
+}
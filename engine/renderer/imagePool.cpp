@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cassert>
+
+#include "imagePool.h"
+
+void ImagePool::init(RenderContext &context, uint32_t extentGranularity, uint32_t capacity)
+{
+    m_context = &context;
+    m_extentGranularity = std::max(extentGranularity, 1U);
+    m_capacity = capacity;
+}
+
+void ImagePool::destroy()
+{
+    if (!m_context)
+        return;
+
+    for (Handle handle = 0; handle < m_entries.size(); ++handle)
+        if (m_entries[handle].image)
+        {
+            assert(!m_entries[handle].inUse && "image still acquired while destroying the pool");
+            destroyEntry(handle);
+        }
+
+    m_entries.clear();
+    m_idleEntries.clear();
+    m_idleCount = 0U;
+    m_freeIndex = ~0U;
+    m_context = nullptr;
+}
+
+ImagePool::Handle ImagePool::acquire(const vk::ImageCreateInfo &info)
+{
+    ImageKey key{};
+    key.flags = info.flags;
+    key.imageType = info.imageType;
+    key.format = info.format;
+    key.extent = info.extent;
+    key.mipLevels = info.mipLevels;
+    key.arrayLayers = info.arrayLayers;
+    key.samples = info.samples;
+    key.tiling = info.tiling;
+    key.usage = info.usage;
+
+    // most recently released first, it is the most likely to still be resident
+    if (auto it = m_idleEntries.find(key); it != m_idleEntries.end() && !it->second.empty())
+    {
+        const Handle handle = it->second.back();
+        it->second.pop_back();
+        --m_idleCount;
+        m_entries[handle].inUse = true;
+        return handle;
+    }
+
+    Handle handle{0U};
+    if (m_freeIndex != ~0U)
+    {
+        handle = m_freeIndex;
+        m_freeIndex = m_entries[handle].nextFreeIndex;
+    }
+    else
+    {
+        handle = static_cast<Handle>(m_entries.size());
+        m_entries.resize(m_entries.size() + 1);
+    }
+
+    auto &entry = m_entries[handle];
+    entry.key = key;
+    entry.image = m_context->createImage(vk::ImageCreateInfo(info).setPNext(nullptr).setInitialLayout(vk::ImageLayout::eUndefined));
+    entry.inUse = true;
+    entry.nextFreeIndex = ~0U;
+
+    const auto viewType = info.imageType == vk::ImageType::e3D ? vk::ImageViewType::e3D : vk::ImageViewType::e2D;
+    entry.mipViews.resize(info.mipLevels);
+    for (uint32_t level = 0; level < info.mipLevels; ++level)
+    {
+        vk::ImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.setImage(*entry.image)
+            .setViewType(viewType)
+            .setFormat(info.format)
+            .setSubresourceRange(vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, level, 1U, 0U, 1U});
+        entry.mipViews[level] = m_context->getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks);
+    }
+    return handle;
+}
+
+void ImagePool::release(Handle handle)
+{
+    if (handle == invalidHandle)
+        return;
+
+    auto &entry = m_entries[handle];
+    assert(entry.inUse);
+    entry.inUse = false;
+    entry.lastReleased = ++m_releaseTick;
+    m_idleEntries[entry.key].push_back(handle);
+    ++m_idleCount;
+
+    evictIdleEntries();
+}
+
+vk::Extent3D ImagePool::roundExtent(const vk::Extent3D &extent) const
+{
+    auto roundUp = [this](uint32_t value)
+    { return std::max((value + m_extentGranularity - 1U) / m_extentGranularity, 1U) * m_extentGranularity; };
+    return vk::Extent3D{roundUp(extent.width), roundUp(extent.height), extent.depth > 1U ? roundUp(extent.depth) : 1U};
+}
+
+void ImagePool::evictIdleEntries()
+{
+    while (m_idleCount > m_capacity)
+    {
+        // capacity is small, a linear scan over idle lists is cheaper than keeping an ordered list in sync
+        std::vector<Handle> *oldestList{nullptr};
+        size_t oldestIndex{0U};
+        for (auto &[key, handles] : m_idleEntries)
+            for (size_t i = 0; i < handles.size(); ++i)
+                if (!oldestList || m_entries[handles[i]].lastReleased < m_entries[(*oldestList)[oldestIndex]].lastReleased)
+                {
+                    oldestList = &handles;
+                    oldestIndex = i;
+                }
+
+        const Handle handle = (*oldestList)[oldestIndex];
+        oldestList->erase(oldestList->begin() + oldestIndex);
+        --m_idleCount;
+        destroyEntry(handle);
+        m_entries[handle].nextFreeIndex = m_freeIndex;
+        m_freeIndex = handle;
+    }
+}
+
+void ImagePool::destroyEntry(Handle handle)
+{
+    auto &entry = m_entries[handle];
+    for (auto view : entry.mipViews)
+        m_context->getDeviceHandle()->destroyImageView(view, allocationCallbacks);
+    entry.mipViews.clear();
+    entry.image.reset();
+    entry.inUse = false;
+}
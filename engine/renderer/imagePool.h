@@ -0,0 +1,99 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <hash.hpp>
+
+#include "renderContext.h"
+
+// recycles images keyed by the hash of their create info, e.g. render targets following the window size
+// extents are meant to be rounded up by roundExtent(), so users render into a sub-rect and small resizes hit the same key
+// released images stay cached and are evicted in least recently used order once more than capacity are idle
+// the pool never waits on GPU, an image must be released only when no pending work uses it
+class ImagePool
+{
+public:
+    using Handle = uint32_t;
+    static constexpr Handle invalidHandle = ~0U;
+
+    ImagePool(ImagePool const &) = delete;
+    ImagePool &operator=(ImagePool const &) = delete;
+
+    ImagePool() {}
+    ~ImagePool() { destroy(); }
+
+    void init(RenderContext &context, uint32_t extentGranularity = 256U, uint32_t capacity = 8U);
+    void destroy();
+
+    // every mip level gets its own view
+    Handle acquire(const vk::ImageCreateInfo &info);
+    void release(Handle handle);
+
+    vk::Extent3D roundExtent(const vk::Extent3D &extent) const;
+
+    vk::Image getImage(Handle handle) const { return *m_entries[handle].image; }
+    vk::ImageView getImageView(Handle handle, uint32_t mipLevel = 0U) const { return m_entries[handle].mipViews[mipLevel]; }
+    vk::Extent3D getExtent(Handle handle) const { return m_entries[handle].key.extent; }
+    uint32_t getMipLevelCount(Handle handle) const { return m_entries[handle].key.mipLevels; }
+
+private:
+    // the part of vk::ImageCreateInfo which makes images interchangeable, pointers are left out
+    struct ImageKey
+    {
+        vk::ImageCreateFlags flags{};
+        vk::ImageType imageType{};
+        vk::Format format{};
+        vk::Extent3D extent{};
+        uint32_t mipLevels{0U};
+        uint32_t arrayLayers{0U};
+        vk::SampleCountFlagBits samples{};
+        vk::ImageTiling tiling{};
+        vk::ImageUsageFlags usage{};
+
+        bool operator==(const ImageKey &other) const = default;
+    };
+
+    struct ImageKeyHasher
+    {
+        std::size_t operator()(const ImageKey &key) const
+        {
+            std::size_t seed{0U};
+            hash_combine(seed, static_cast<VkImageCreateFlags>(key.flags));
+            hash_combine(seed, static_cast<std::size_t>(key.imageType));
+            hash_combine(seed, static_cast<std::size_t>(key.format));
+            hash_combine(seed, key.extent.width);
+            hash_combine(seed, key.extent.height);
+            hash_combine(seed, key.extent.depth);
+            hash_combine(seed, key.mipLevels);
+            hash_combine(seed, key.arrayLayers);
+            hash_combine(seed, static_cast<std::size_t>(key.samples));
+            hash_combine(seed, static_cast<std::size_t>(key.tiling));
+            hash_combine(seed, static_cast<VkImageUsageFlags>(key.usage));
+            return seed;
+        }
+    };
+
+    struct Entry
+    {
+        ImageKey key{};
+        std::shared_ptr<Image> image{};
+        std::vector<vk::ImageView> mipViews{};
+        uint64_t lastReleased{0U}; // release tick, ordering idle entries for eviction
+        bool inUse{false};
+        uint32_t nextFreeIndex{~0U};
+    };
+
+    void evictIdleEntries();
+    void destroyEntry(Handle handle);
+
+    RenderContext *m_context{nullptr};
+    uint32_t m_extentGranularity{1U};
+    uint32_t m_capacity{0U};
+    uint64_t m_releaseTick{0U};
+
+    std::vector<Entry> m_entries{};
+    uint32_t m_freeIndex{~0U}; // destroyed entries available for reuse
+    std::unordered_map<ImageKey, std::vector<Handle>, ImageKeyHasher> m_idleEntries{};
+    uint32_t m_idleCount{0U};
+};
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <exception>
+#include <string_view>
 
 #include "renderContext.h"
 
@@ -39,13 +41,15 @@ VKAPI_ATTR void VKAPI_CALL vkDestroyDebugReportCallbackEXT(VkInstance instance,
 #endif
 
 RenderContext::RenderContext(const std::vector<const char *> &instanceExtensions, const std::vector<const char *> &instanceLayers,
-                             const std::vector<const char *> &deviceExtensions, const std::vector<const char *> &deviceLayers)
+                             const std::vector<const char *> &deviceExtensions, const std::vector<const char *> &deviceLayers,
+                             const std::vector<const char *> &optionalDeviceExtensions)
 {
-    init(instanceExtensions, instanceLayers, deviceExtensions, deviceLayers);
+    init(instanceExtensions, instanceLayers, deviceExtensions, deviceLayers, optionalDeviceExtensions);
 }
 
 void RenderContext::init(const std::vector<const char *> &instanceExtensions, const std::vector<const char *> &instanceLayers,
-                         const std::vector<const char *> &deviceExtensions, const std::vector<const char *> &deviceLayers)
+                         const std::vector<const char *> &deviceExtensions, const std::vector<const char *> &deviceLayers,
+                         const std::vector<const char *> &optionalDeviceExtensions)
 {
     vk::ApplicationInfo appInfo;
     appInfo.setApiVersion(VK_API_VERSION_1_3);
@@ -142,28 +146,28 @@ void RenderContext::init(const std::vector<const char *> &instanceExtensions, co
                                                          vk::PhysicalDeviceVulkan11Features,
                                                          vk::PhysicalDeviceVulkan12Features,
                                                          vk::PhysicalDeviceVulkan13Features,
-                                                         vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT>();
+                                                         vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT,
+                                                         vk::PhysicalDeviceShaderImageAtomicInt64FeaturesEXT>();
 
     auto queueFamilyProperties = m_adapterHandle->getQueueFamilyProperties2();
+    // take the first graphics family, and the first compute-only family as async compute queue
+    // transfer work stays on the graphics family, so that uploaded resources never need an ownership transfer
     for (auto i = 0; i < queueFamilyProperties.size(); ++i)
     {
-        if (queueFamilyProperties[i].queueFamilyProperties.queueFlags & vk::QueueFlagBits::eGraphics)
+        const auto queueFlags = queueFamilyProperties[i].queueFamilyProperties.queueFlags;
+        if (m_graphicsQueueHandle.queue_family_index == ~0U && (queueFlags & vk::QueueFlagBits::eGraphics))
             m_graphicsQueueHandle.queue_family_index = i;
-        if (m_graphicsQueueHandle.queue_family_index != i &&
-            (queueFamilyProperties[i].queueFamilyProperties.queueFlags & vk::QueueFlagBits::eCompute))
-            m_computeQueueHandle->queue_family_index = i;
-        if (m_graphicsQueueHandle.queue_family_index != i &&
-            m_computeQueueHandle->queue_family_index != i &&
-            (queueFamilyProperties[i].queueFamilyProperties.queueFlags & vk::QueueFlagBits::eTransfer))
-            m_transferQueueHandle->queue_family_index = i;
+        else if (!m_computeQueueHandle.has_value() &&
+                 !(queueFlags & vk::QueueFlagBits::eGraphics) && (queueFlags & vk::QueueFlagBits::eCompute))
+            m_computeQueueHandle.emplace().queue_family_index = i;
     }
 
     std::vector<const char *> _deviceExtensions{deviceExtensions};
     std::vector<const char *> _deviceLayers{deviceLayers};
     _deviceExtensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     _deviceExtensions.emplace_back(VK_KHR_SHADER_NON_SEMANTIC_INFO_EXTENSION_NAME);
-#ifdef VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME
     auto deviceExtProperties = m_adapterHandle->enumerateDeviceExtensionProperties();
+#ifdef VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME
     for (const auto &property : deviceExtProperties)
     {
         if (property.extensionName == VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME)
@@ -172,14 +176,24 @@ void RenderContext::init(const std::vector<const char *> &instanceExtensions, co
         }
     }
 #endif
+    for (const auto *extensionName : optionalDeviceExtensions)
+        if (std::any_of(deviceExtProperties.begin(), deviceExtProperties.end(), [extensionName](const vk::ExtensionProperties &property)
+                        { return std::string_view{property.extensionName} == extensionName; }))
+            _deviceExtensions.emplace_back(extensionName);
+    m_enabledDeviceExtensions.assign(_deviceExtensions.begin(), _deviceExtensions.end());
+
+    // feature structs of extensions left disabled must not reach device creation
+    if (!isDeviceExtensionEnabled(VK_EXT_FRAGMENT_SHADER_INTERLOCK_EXTENSION_NAME))
+        adapterFeatures.unlink<vk::PhysicalDeviceFragmentShaderInterlockFeaturesEXT>();
+    if (!isDeviceExtensionEnabled(VK_EXT_SHADER_IMAGE_ATOMIC_INT64_EXTENSION_NAME))
+        adapterFeatures.unlink<vk::PhysicalDeviceShaderImageAtomicInt64FeaturesEXT>();
 
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos{};
-    queueCreateInfos.resize(1 + m_computeQueueHandle.has_value() + m_transferQueueHandle.has_value());
-    queueCreateInfos[0].setQueueCount(1U).setQueueFamilyIndex(m_graphicsQueueHandle.queue_family_index).setQueuePriorities(m_graphicsQueueHandle.queue_priority);
+    queueCreateInfos.emplace_back().setQueueCount(1U).setQueueFamilyIndex(m_graphicsQueueHandle.queue_family_index).setQueuePriorities(m_graphicsQueueHandle.queue_priority);
     if (m_computeQueueHandle.has_value())
-        queueCreateInfos[1].setQueueCount(1U).setQueueFamilyIndex(m_computeQueueHandle->queue_family_index).setQueuePriorities(m_computeQueueHandle->queue_priority);
+        queueCreateInfos.emplace_back().setQueueCount(1U).setQueueFamilyIndex(m_computeQueueHandle->queue_family_index).setQueuePriorities(m_computeQueueHandle->queue_priority);
     if (m_transferQueueHandle.has_value())
-        queueCreateInfos[2].setQueueCount(1U).setQueueFamilyIndex(m_transferQueueHandle->queue_family_index).setQueuePriorities(m_transferQueueHandle->queue_priority);
+        queueCreateInfos.emplace_back().setQueueCount(1U).setQueueFamilyIndex(m_transferQueueHandle->queue_family_index).setQueuePriorities(m_transferQueueHandle->queue_priority);
     vk::DeviceCreateInfo deviceCreateInfo;
     deviceCreateInfo.setQueueCreateInfos(queueCreateInfos)
         .setPEnabledExtensionNames(_deviceExtensions);
@@ -345,6 +359,35 @@ std::shared_ptr<Image> RenderContext::createImage(const vk::ImageCreateInfo &inf
     return std::make_shared<Image>(imageObject, memHandle, m_deviceHandle, m_memAlloc.get());
 }
 
+vk::MemoryRequirements RenderContext::getImageMemoryRequirements(const vk::ImageCreateInfo &info_) const
+{
+    vk::DeviceImageMemoryRequirements imageReqs{};
+    imageReqs.setPCreateInfo(&info_);
+    return m_deviceHandle->getImageMemoryRequirements(imageReqs).memoryRequirements;
+}
+
+MemoryHandle RenderContext::allocateMemoryBlock(const vk::MemoryRequirements &reqs_, const vk::MemoryPropertyFlags memUsage_)
+{
+    MemoryAllocateInfo allocInfo(reqs_, memUsage_, true);
+    return allocateMemory(allocInfo);
+}
+
+void RenderContext::freeMemoryBlock(MemoryHandle memHandle_)
+{
+    m_memAlloc->freeMemory(memHandle_);
+}
+
+std::shared_ptr<Image> RenderContext::createPlacedImage(const vk::ImageCreateInfo &info_, MemoryHandle block_, vk::DeviceSize offset_)
+{
+    vk::Image imageObject;
+    createImageEx(info_, imageObject);
+
+    const auto memInfo = m_memAlloc->getMemoryInfo(block_);
+    m_deviceHandle->bindImageMemory(imageObject, memInfo.memory, memInfo.offset + offset_);
+
+    return std::make_shared<Image>(imageObject, nullptr, m_deviceHandle, m_memAlloc.get());
+}
+
 std::shared_ptr<Image> RenderContext::createImage(size_t size_,
                                                   const void *data_,
                                                   const vk::ImageCreateInfo &info_,
@@ -604,6 +647,11 @@ std::shared_ptr<QueueInstance> RenderContext::getQueueInstanceHandle(vk::QueueFl
     }
 }
 
+bool RenderContext::isDeviceExtensionEnabled(const char *extensionName) const
+{
+    return std::find(m_enabledDeviceExtensions.begin(), m_enabledDeviceExtensions.end(), extensionName) != m_enabledDeviceExtensions.end();
+}
+
 void RenderContext::destroy()
 {
     m_memAlloc.reset();
@@ -2,6 +2,7 @@
 
 #include <unordered_map>
 #include <vector>
+#include <string>
 #include <optional>
 #include <iostream>
 
@@ -12,11 +13,14 @@ struct RenderContext
 public:
     RenderContext() = default;
     RenderContext(const std::vector<const char *> &instanceExtensions, const std::vector<const char *> &instanceLayers,
-                  const std::vector<const char *> &deviceExtensions, const std::vector<const char *> &deviceLayers);
+                  const std::vector<const char *> &deviceExtensions, const std::vector<const char *> &deviceLayers,
+                  const std::vector<const char *> &optionalDeviceExtensions = {});
     ~RenderContext() { destroy(); }
 
+    // optional device extensions are enabled only when the adapter supports them, query with isDeviceExtensionEnabled()
     void init(const std::vector<const char *> &instanceExtensions, const std::vector<const char *> &instanceLayers,
-              const std::vector<const char *> &deviceExtensions, const std::vector<const char *> &deviceLayers);
+              const std::vector<const char *> &deviceExtensions, const std::vector<const char *> &deviceLayers,
+              const std::vector<const char *> &optionalDeviceExtensions = {});
 
     //--------------------------------------------------------------------------------------------------
     // Basic buffer creation
@@ -53,6 +57,15 @@ public:
     // Basic image creation
     std::shared_ptr<Image> createImage(const vk::ImageCreateInfo &info_, const vk::MemoryPropertyFlags memUsage_ = vk::MemoryPropertyFlagBits::eDeviceLocal);
 
+    //--------------------------------------------------------------------------------------------------
+    // Memory placement, e.g. for aliasing transient images
+    // a block is a raw allocation resources are placed into, it must outlive every resource placed into it
+    vk::MemoryRequirements getImageMemoryRequirements(const vk::ImageCreateInfo &info_) const;
+    MemoryHandle allocateMemoryBlock(const vk::MemoryRequirements &reqs_, const vk::MemoryPropertyFlags memUsage_ = vk::MemoryPropertyFlagBits::eDeviceLocal);
+    void freeMemoryBlock(MemoryHandle memHandle_);
+    // the returned image does not own its memory
+    std::shared_ptr<Image> createPlacedImage(const vk::ImageCreateInfo &info_, MemoryHandle block_, vk::DeviceSize offset_ = 0ULL);
+
     //--------------------------------------------------------------------------------------------------
     // Create an image with data uploaded through staging manager
     std::shared_ptr<Image> createImage(size_t size_,
@@ -93,6 +106,7 @@ public:
     std::shared_ptr<vk::Device> getDeviceHandle() const noexcept { return m_deviceHandle; }
     std::shared_ptr<QueueInstance> getQueueInstanceHandle(vk::QueueFlagBits type, bool mustSeparate = true) const;
     std::shared_ptr<vk::PipelineCache> getPipelineCacheHandle() const noexcept { return std::make_shared<vk::PipelineCache>(m_pipelineCacheHandle); }
+    bool isDeviceExtensionEnabled(const char *extensionName) const;
 
     void destroy();
 
@@ -107,6 +121,7 @@ private:
     std::shared_ptr<vk::PhysicalDevice> m_adapterHandle;
     std::shared_ptr<vk::Device> m_deviceHandle;
     vk::PipelineCache m_pipelineCacheHandle;
+    std::vector<std::string> m_enabledDeviceExtensions{};
 
     QueueInstance m_graphicsQueueHandle;
     std::optional<QueueInstance> m_computeQueueHandle{};
@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <cassert>
+
+#include "renderGraph.h"
+
+static constexpr vk::AccessFlags2 writeAccessMask = vk::AccessFlagBits2::eShaderWrite |
+                                                    vk::AccessFlagBits2::eShaderStorageWrite |
+                                                    vk::AccessFlagBits2::eColorAttachmentWrite |
+                                                    vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+                                                    vk::AccessFlagBits2::eTransferWrite |
+                                                    vk::AccessFlagBits2::eHostWrite |
+                                                    vk::AccessFlagBits2::eMemoryWrite;
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::read(ResourceHandle resource, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access, vk::ImageLayout layout)
+{
+    return use(resource, Access{stages, access, layout}, false, false);
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::write(ResourceHandle resource, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access, vk::ImageLayout layout)
+{
+    return use(resource, Access{stages, access, layout}, true, false);
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::discard(ResourceHandle resource, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access, vk::ImageLayout layout)
+{
+    return use(resource, Access{stages, access, layout}, true, true);
+}
+
+RenderGraph::PassBuilder &RenderGraph::PassBuilder::use(ResourceHandle resource, const Access &access, bool isWrite, bool isDiscard)
+{
+    assert(resource < m_graph.m_resources.size());
+    auto &usages = m_graph.m_passes[m_passIndex].usages;
+
+    // several usages of one resource inside a pass collapse into one, a pass cannot change layouts midway
+    auto found = std::find_if(usages.begin(), usages.end(), [resource](const Usage &usage)
+                              { return usage.resource == resource; });
+    if (found != usages.end())
+    {
+        assert(found->access.layout == access.layout);
+        found->access.stages |= access.stages;
+        found->access.access |= access.access;
+        found->isDiscard = found->isDiscard && isDiscard;
+        found->isWrite |= isWrite;
+        return *this;
+    }
+
+    usages.push_back(Usage{resource, access, isWrite, isDiscard});
+    return *this;
+}
+
+RenderGraph::ResourceHandle RenderGraph::importImage(const std::string &name, vk::Image image, const vk::ImageSubresourceRange &range, const Access &lastAccess)
+{
+    assert(!m_compiled);
+    Resource resource{};
+    resource.name = name;
+    resource.isImage = true;
+    resource.image = image;
+    resource.range = range;
+    resource.lastAccess = lastAccess;
+    m_resources.push_back(std::move(resource));
+    return static_cast<ResourceHandle>(m_resources.size() - 1U);
+}
+
+RenderGraph::ResourceHandle RenderGraph::importBuffer(const std::string &name, vk::Buffer buffer, const Access &lastAccess)
+{
+    assert(!m_compiled);
+    Resource resource{};
+    resource.name = name;
+    resource.buffer = buffer;
+    resource.lastAccess = lastAccess;
+    m_resources.push_back(std::move(resource));
+    return static_cast<ResourceHandle>(m_resources.size() - 1U);
+}
+
+RenderGraph::ResourceHandle RenderGraph::createImage(const std::string &name, const vk::ImageCreateInfo &info)
+{
+    assert(!m_compiled);
+    Resource resource{};
+    resource.name = name;
+    resource.isImage = true;
+    resource.isTransient = true;
+    resource.createInfo = info;
+    resource.createInfo.setInitialLayout(vk::ImageLayout::eUndefined);
+    resource.range = vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, 0U, info.mipLevels, 0U, info.arrayLayers};
+    resource.lastAccess.layout = vk::ImageLayout::eUndefined;
+    m_resources.push_back(std::move(resource));
+    return static_cast<ResourceHandle>(m_resources.size() - 1U);
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const std::string &name, ExecuteFunc execute)
+{
+    assert(!m_compiled);
+    Pass pass{};
+    pass.name = name;
+    pass.execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+    return PassBuilder(*this, static_cast<uint32_t>(m_passes.size() - 1U));
+}
+
+void RenderGraph::markOutput(ResourceHandle resource, const Access &nextAccess)
+{
+    assert(resource < m_resources.size());
+    m_resources[resource].isOutput = true;
+    m_resources[resource].nextAccess = nextAccess;
+}
+
+void RenderGraph::compile(RenderContext &context)
+{
+    assert(!m_compiled);
+    m_context = &context;
+
+    cullPasses();
+    allocateTransients(context);
+    bakeBarriers();
+
+    m_compiled = true;
+}
+
+void RenderGraph::execute(vk::CommandBuffer &cmdBuffer) const
+{
+    assert(m_compiled);
+
+    auto recordBarriers = [&cmdBuffer](const vk::MemoryBarrier2 &memoryBarrier, const std::vector<vk::ImageMemoryBarrier2> &imageBarriers)
+    {
+        const bool hasMemoryBarrier = memoryBarrier.srcStageMask || memoryBarrier.dstStageMask;
+        if (!hasMemoryBarrier && imageBarriers.empty())
+            return;
+
+        vk::DependencyInfo dependencyInfo{};
+        if (hasMemoryBarrier)
+            dependencyInfo.setMemoryBarriers(memoryBarrier);
+        dependencyInfo.setImageMemoryBarriers(imageBarriers);
+        cmdBuffer.pipelineBarrier2(dependencyInfo);
+    };
+
+    for (const auto &pass : m_passes)
+    {
+        if (!pass.active)
+            continue;
+
+        recordBarriers(pass.memoryBarrier, pass.imageBarriers);
+        pass.execute(cmdBuffer);
+    }
+    recordBarriers(m_finalMemoryBarrier, m_finalImageBarriers);
+}
+
+void RenderGraph::reset()
+{
+    for (auto &resource : m_resources)
+    {
+        for (auto view : resource.mipViews)
+            m_context->getDeviceHandle()->destroyImageView(view, allocationCallbacks);
+        // placed images go before the memory they live in
+        resource.ownedImage.reset();
+    }
+    for (auto block : m_memoryBlocks)
+        m_context->freeMemoryBlock(block);
+
+    m_memoryBlocks.clear();
+    m_passes.clear();
+    m_resources.clear();
+    m_finalMemoryBarrier = vk::MemoryBarrier2{};
+    m_finalImageBarriers.clear();
+    m_compiled = false;
+}
+
+bool RenderGraph::isPassActive(const std::string &name) const
+{
+    for (const auto &pass : m_passes)
+        if (pass.name == name)
+            return pass.active;
+    return false;
+}
+
+void RenderGraph::cullPasses()
+{
+    std::vector<bool> isNeeded(m_resources.size(), false);
+    for (size_t i = 0; i < m_resources.size(); ++i)
+        isNeeded[i] = m_resources[i].isOutput;
+
+    // walk backwards, a pass survives when it writes something a later survivor or an output depends on
+    for (auto pass = m_passes.rbegin(); pass != m_passes.rend(); ++pass)
+    {
+        pass->active = std::any_of(pass->usages.begin(), pass->usages.end(), [&isNeeded](const Usage &usage)
+                                   { return usage.isWrite && isNeeded[usage.resource]; });
+        if (!pass->active)
+            continue;
+
+        // discarded contents are not needed from earlier passes, anything else read or partially written is
+        for (const auto &usage : pass->usages)
+            isNeeded[usage.resource] = !usage.isDiscard;
+    }
+}
+
+void RenderGraph::allocateTransients(RenderContext &context)
+{
+    std::vector<ResourceHandle> transients{};
+    for (uint32_t passIndex = 0; passIndex < m_passes.size(); ++passIndex)
+    {
+        if (!m_passes[passIndex].active)
+            continue;
+
+        for (const auto &usage : m_passes[passIndex].usages)
+        {
+            auto &resource = m_resources[usage.resource];
+            if (!resource.isTransient)
+                continue;
+
+            if (resource.firstPass == ~0U)
+            {
+                resource.firstPass = passIndex;
+                transients.push_back(usage.resource);
+            }
+            resource.lastPass = passIndex;
+        }
+    }
+    // outputs are read after the graph, so nothing may be placed over them
+    for (auto handle : transients)
+        if (m_resources[handle].isOutput)
+            m_resources[handle].lastPass = static_cast<uint32_t>(m_passes.size());
+
+    // greedy interval packing, transients already come sorted by their first pass
+    struct MemorySlot
+    {
+        vk::MemoryRequirements reqs{};
+        uint32_t lastPass{0U};
+        ResourceHandle lastOccupant{~0U};
+    };
+    std::vector<MemorySlot> slots{};
+    std::vector<vk::MemoryRequirements> resourceReqs(m_resources.size());
+    for (auto handle : transients)
+    {
+        auto &resource = m_resources[handle];
+        const auto reqs = context.getImageMemoryRequirements(resource.createInfo);
+        resourceReqs[handle] = reqs;
+
+        auto slot = std::find_if(slots.begin(), slots.end(), [&](const MemorySlot &slot)
+                                 { return slot.lastPass < resource.firstPass && (slot.reqs.memoryTypeBits & reqs.memoryTypeBits); });
+        if (slot == slots.end())
+        {
+            slots.push_back(MemorySlot{reqs, resource.lastPass, handle});
+            resource.memoryBlock = static_cast<uint32_t>(slots.size() - 1U);
+            continue;
+        }
+
+        slot->reqs.size = std::max(slot->reqs.size, reqs.size);
+        slot->reqs.alignment = std::max(slot->reqs.alignment, reqs.alignment);
+        slot->reqs.memoryTypeBits &= reqs.memoryTypeBits;
+        resource.aliasedResource = slot->lastOccupant;
+        resource.memoryBlock = static_cast<uint32_t>(slot - slots.begin());
+        slot->lastPass = resource.lastPass;
+        slot->lastOccupant = handle;
+    }
+
+    m_memoryBlocks.reserve(slots.size());
+    for (const auto &slot : slots)
+        m_memoryBlocks.push_back(context.allocateMemoryBlock(slot.reqs));
+
+    for (auto handle : transients)
+    {
+        auto &resource = m_resources[handle];
+        resource.ownedImage = context.createPlacedImage(resource.createInfo, m_memoryBlocks[resource.memoryBlock]);
+        resource.image = *resource.ownedImage;
+
+        const auto viewType = resource.createInfo.imageType == vk::ImageType::e3D ? vk::ImageViewType::e3D : vk::ImageViewType::e2D;
+        for (uint32_t level = 0; level < resource.createInfo.mipLevels; ++level)
+        {
+            vk::ImageViewCreateInfo viewCreateInfo{};
+            viewCreateInfo.setImage(resource.image)
+                .setViewType(viewType)
+                .setFormat(resource.createInfo.format)
+                .setSubresourceRange(vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eColor, level, 1U, 0U, 1U});
+            resource.mipViews.push_back(context.getDeviceHandle()->createImageView(viewCreateInfo, allocationCallbacks));
+        }
+    }
+}
+
+void RenderGraph::bakeBarriers()
+{
+    std::vector<State> states(m_resources.size());
+    for (size_t i = 0; i < m_resources.size(); ++i)
+    {
+        const auto &lastAccess = m_resources[i].lastAccess;
+        states[i].writeStages = lastAccess.stages;
+        states[i].writeAccess = lastAccess.access & writeAccessMask;
+        states[i].layout = lastAccess.layout;
+    }
+
+    for (auto &pass : m_passes)
+    {
+        if (!pass.active)
+            continue;
+
+        for (const auto &usage : pass.usages)
+        {
+            const auto &resource = m_resources[usage.resource];
+            auto &state = states[usage.resource];
+
+            // the first user of aliased memory waits until the previous occupant is done with it
+            if (resource.isTransient && resource.firstPass == static_cast<uint32_t>(&pass - m_passes.data()) && resource.aliasedResource != ~0U)
+            {
+                const auto &previous = states[resource.aliasedResource];
+                state.writeStages = previous.writeStages | previous.readStages;
+                state.writeAccess = previous.writeAccess;
+            }
+
+            appendBarrier(pass.memoryBarrier, pass.imageBarriers, resource, state, usage.access, usage.isWrite, usage.isDiscard);
+        }
+    }
+
+    for (size_t i = 0; i < m_resources.size(); ++i)
+    {
+        const auto &resource = m_resources[i];
+        if (resource.isOutput && resource.nextAccess.stages)
+            appendBarrier(m_finalMemoryBarrier, m_finalImageBarriers, resource, states[i], resource.nextAccess, false, false);
+    }
+}
+
+void RenderGraph::appendBarrier(vk::MemoryBarrier2 &memoryBarrier, std::vector<vk::ImageMemoryBarrier2> &imageBarriers,
+                                const Resource &resource, State &state, const Access &access, bool isWrite, bool isDiscard) const
+{
+    const auto previousStages = state.writeStages | state.readStages;
+
+    if (resource.isImage && (isDiscard || state.layout != access.layout))
+    {
+        vk::ImageMemoryBarrier2 imageBarrier{};
+        imageBarrier.setSrcStageMask(previousStages ? previousStages : vk::PipelineStageFlagBits2::eNone)
+            .setSrcAccessMask(state.writeAccess)
+            .setDstStageMask(access.stages)
+            .setDstAccessMask(access.access)
+            .setOldLayout(isDiscard ? vk::ImageLayout::eUndefined : state.layout)
+            .setNewLayout(access.layout)
+            .setImage(resource.image)
+            .setSubresourceRange(resource.range);
+        imageBarriers.push_back(imageBarrier);
+
+        // the transition is itself a write every later access has to wait for
+        state.writeStages = access.stages;
+        state.writeAccess = isWrite ? access.access & writeAccessMask : vk::AccessFlags2{};
+        state.readStages = isWrite ? vk::PipelineStageFlags2{} : access.stages;
+        state.readAccess = isWrite ? vk::AccessFlags2{} : access.access;
+        state.layout = access.layout;
+        return;
+    }
+
+    if (isWrite)
+    {
+        // write after read only needs an execution dependency, write after write also flushes the previous writes
+        if (previousStages)
+        {
+            memoryBarrier.srcStageMask |= previousStages;
+            memoryBarrier.srcAccessMask |= state.writeAccess;
+            memoryBarrier.dstStageMask |= access.stages;
+            memoryBarrier.dstAccessMask |= access.access;
+        }
+        state.writeStages = access.stages;
+        state.writeAccess = access.access & writeAccessMask;
+        state.readStages = vk::PipelineStageFlags2{};
+        state.readAccess = vk::AccessFlags2{};
+        return;
+    }
+
+    // read after write, skipped when an earlier barrier already made the writes visible to these stages
+    const bool isCovered = (access.stages & ~state.readStages) == vk::PipelineStageFlags2{} &&
+                           (access.access & ~state.readAccess) == vk::AccessFlags2{};
+    if (state.writeStages && !isCovered)
+    {
+        memoryBarrier.srcStageMask |= state.writeStages;
+        memoryBarrier.srcAccessMask |= state.writeAccess;
+        memoryBarrier.dstStageMask |= access.stages;
+        memoryBarrier.dstAccessMask |= access.access;
+    }
+    state.readStages |= access.stages;
+    state.readAccess |= access.access;
+}
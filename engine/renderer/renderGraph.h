@@ -0,0 +1,144 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "renderContext.h"
+
+// declarative pass list recorded into a single command buffer
+// every pass declares how it accesses resources, then compile():
+// - culls passes that no output depends on
+// - places transient images into shared memory when their lifetimes do not overlap
+// - derives the barriers between passes from the declared accesses
+// cross queue ownership transfers are left to the caller, before execute() and after it
+class RenderGraph
+{
+public:
+    using ResourceHandle = uint32_t;
+    using ExecuteFunc = std::function<void(vk::CommandBuffer &)>;
+
+    struct Access
+    {
+        vk::PipelineStageFlags2 stages{};
+        vk::AccessFlags2 access{};
+        vk::ImageLayout layout{vk::ImageLayout::eGeneral}; // ignored by buffers
+    };
+
+    class PassBuilder
+    {
+    public:
+        PassBuilder &read(ResourceHandle resource, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access, vk::ImageLayout layout = vk::ImageLayout::eGeneral);
+        PassBuilder &write(ResourceHandle resource, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access, vk::ImageLayout layout = vk::ImageLayout::eGeneral);
+        // overwrites the whole resource without reading it, previous contents are dropped
+        PassBuilder &discard(ResourceHandle resource, vk::PipelineStageFlags2 stages, vk::AccessFlags2 access, vk::ImageLayout layout = vk::ImageLayout::eGeneral);
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph &graph, uint32_t passIndex) : m_graph(graph), m_passIndex(passIndex) {}
+
+        PassBuilder &use(ResourceHandle resource, const Access &access, bool isWrite, bool isDiscard);
+
+        RenderGraph &m_graph;
+        uint32_t m_passIndex;
+    };
+
+    RenderGraph(RenderGraph const &) = delete;
+    RenderGraph &operator=(RenderGraph const &) = delete;
+
+    RenderGraph() {}
+    ~RenderGraph() { reset(); }
+
+    /* declaration */
+    // lastAccess describes how the resource was touched right before the graph, empty stages means already synchronized
+    ResourceHandle importImage(const std::string &name, vk::Image image, const vk::ImageSubresourceRange &range, const Access &lastAccess = {});
+    ResourceHandle importBuffer(const std::string &name, vk::Buffer buffer, const Access &lastAccess = {});
+    // owned by the graph, contents do not survive between executions
+    ResourceHandle createImage(const std::string &name, const vk::ImageCreateInfo &info);
+    PassBuilder addPass(const std::string &name, ExecuteFunc execute);
+    // passes are kept only when an output depends on them
+    // nextAccess makes the final contents visible to later work on the same queue, empty stages leave it to the caller
+    void markOutput(ResourceHandle resource, const Access &nextAccess = {});
+
+    /* baking */
+    void compile(RenderContext &context);
+    void execute(vk::CommandBuffer &cmdBuffer) const;
+    // drops every declaration and frees transient images
+    void reset();
+
+    bool isCompiled() const noexcept { return m_compiled; }
+    bool isPassActive(const std::string &name) const;
+    vk::Image getImage(ResourceHandle resource) const { return m_resources[resource].image; }
+    // transient images only, one view per mip level
+    vk::ImageView getImageView(ResourceHandle resource, uint32_t mipLevel = 0U) const { return m_resources[resource].mipViews[mipLevel]; }
+
+private:
+    struct Usage
+    {
+        ResourceHandle resource;
+        Access access;
+        bool isWrite;
+        bool isDiscard;
+    };
+
+    struct Pass
+    {
+        std::string name{};
+        ExecuteFunc execute{};
+        std::vector<Usage> usages{};
+        bool active{false};
+
+        // baked by compile()
+        vk::MemoryBarrier2 memoryBarrier{};
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers{};
+    };
+
+    struct Resource
+    {
+        std::string name{};
+        bool isImage{false};
+        bool isTransient{false};
+        vk::Image image{};
+        vk::Buffer buffer{};
+        vk::ImageSubresourceRange range{};
+        Access lastAccess{};
+        bool isOutput{false};
+        Access nextAccess{};
+
+        // transient only
+        vk::ImageCreateInfo createInfo{};
+        std::shared_ptr<Image> ownedImage{};
+        std::vector<vk::ImageView> mipViews{};
+        uint32_t firstPass{~0U};
+        uint32_t lastPass{0U};
+        uint32_t memoryBlock{~0U};
+        ResourceHandle aliasedResource{~0U}; // previous occupant of the same memory
+    };
+
+    // hazard tracking state of a resource while walking passes in order
+    struct State
+    {
+        vk::PipelineStageFlags2 writeStages{};
+        vk::AccessFlags2 writeAccess{};
+        vk::PipelineStageFlags2 readStages{}; // readers since last write, writes are already visible to them
+        vk::AccessFlags2 readAccess{};
+        vk::ImageLayout layout{vk::ImageLayout::eUndefined};
+    };
+
+    void cullPasses();
+    void allocateTransients(RenderContext &context);
+    void bakeBarriers();
+    void appendBarrier(vk::MemoryBarrier2 &memoryBarrier, std::vector<vk::ImageMemoryBarrier2> &imageBarriers,
+                       const Resource &resource, State &state, const Access &access, bool isWrite, bool isDiscard) const;
+
+    std::vector<Pass> m_passes{};
+    std::vector<Resource> m_resources{};
+    bool m_compiled{false};
+
+    RenderContext *m_context{nullptr};
+    std::vector<MemoryHandle> m_memoryBlocks{};
+
+    // barriers handing outputs to later work
+    vk::MemoryBarrier2 m_finalMemoryBarrier{};
+    std::vector<vk::ImageMemoryBarrier2> m_finalImageBarriers{};
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// fixed size pool of worker threads consuming a FIFO task queue
+// tasks must not wait on other tasks of the same pool, otherwise small pools may deadlock
+class ThreadPool
+{
+public:
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator=(ThreadPool const &) = delete;
+
+    explicit ThreadPool(size_t threadCount = std::max(std::thread::hardware_concurrency(), 2U) - 1U)
+    {
+        m_workers.reserve(threadCount);
+        for (auto i = 0; i < threadCount; ++i)
+            m_workers.emplace_back([this]()
+                                   { workerLoop(); });
+    }
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+        for (auto &worker : m_workers)
+            worker.join();
+    }
+
+    template <typename F>
+    auto submit(F &&func) -> std::future<std::invoke_result_t<F>>
+    {
+        // std::function requires copyable callables, so the move-only task is shared
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(func));
+        auto result = task->get_future();
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.emplace([task]()
+                            { (*task)(); });
+        }
+        m_condition.notify_one();
+        return result;
+    }
+
+    size_t size() const noexcept { return m_workers.size(); }
+
+private:
+    void workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_condition.wait(lock, [this]()
+                                 { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping && m_tasks.empty())
+                    return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> m_workers{};
+    std::queue<std::function<void()>> m_tasks{};
+    std::mutex m_mutex{};
+    std::condition_variable m_condition{};
+    bool m_stopping{false};
+};
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <sstream>
+
+#define GLM_FORCE_SWIZZLE
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "applicationBase.hpp"
+
+static void printUsage()
+{
+    std::cout << "usage: Headless [options]\n"
+                 "    --model <path>                 wavefront .obj model to render\n"
+                 "    --mode <index|all>             rendering mode, may be repeated\n"
+                 "    --size <width>x<height>        render resolution\n"
+                 "    --frames <count>               frames rendered per mode\n"
+                 "    --camera <ex,ey,ez,cx,cy,cz>   eye and center, fitted to the model by default\n"
+                 "    --output <path.ppm>            readback of the last frame, suffixed by mode when several are rendered\n"
+                 "rendering modes:\n";
+    for (int i = 0; i < std::size(g_renderingModeText); ++i)
+        std::cout << "    " << i << ": " << g_renderingModeText[i] << "\n";
+}
+
+static bool parseFloats(const std::string &text, float *values, size_t count)
+{
+    std::stringstream stream(text);
+    for (size_t i = 0; i < count; ++i)
+    {
+        char separator{','};
+        if ((i > 0 && !(stream >> separator)) || separator != ',' || !(stream >> values[i]))
+            return false;
+    }
+    return stream.eof() || stream.peek() == std::char_traits<char>::eof();
+}
+
+static bool parseOptions(int argc, char **argv, HeadlessOptions &options)
+{
+    bool hasMode{false};
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option{argv[i]};
+        if (option == "--help" || option == "-h" || i + 1 >= argc)
+            return false;
+
+        const std::string value{argv[++i]};
+        if (option == "--model")
+            options.modelPath = value;
+        else if (option == "--mode")
+        {
+            if (!hasMode)
+                options.modes.clear();
+            hasMode = true;
+            if (value == "all")
+            {
+                for (int mode = 0; mode < std::size(g_renderingModeText); ++mode)
+                    options.modes.push_back(static_cast<eRenderingMode>(mode));
+                continue;
+            }
+            const int mode = std::atoi(value.c_str());
+            if (mode < 0 || mode >= std::size(g_renderingModeText))
+                return false;
+            options.modes.push_back(static_cast<eRenderingMode>(mode));
+        }
+        else if (option == "--size")
+        {
+            if (std::sscanf(value.c_str(), "%ux%u", &options.size.width, &options.size.height) != 2 || options.size.width == 0 || options.size.height == 0)
+                return false;
+        }
+        else if (option == "--frames")
+            options.frameCount = static_cast<uint32_t>(std::max(std::atoi(value.c_str()), 1));
+        else if (option == "--camera")
+        {
+            std::array<glm::vec3, 2> camera{};
+            if (!parseFloats(value, &camera[0].x, 6))
+                return false;
+            options.camera = camera;
+        }
+        else if (option == "--output")
+            options.outputPath = value;
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    spdlog::set_level(spdlog::level::level_enum::info);
+
+    HeadlessOptions options{};
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return -1;
+    }
+
+    ApplicationBase app{};
+    return app.runHeadless(options);
+}
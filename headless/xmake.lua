@@ -0,0 +1,9 @@
+target("Headless")
+    set_kind("binary")
+    add_includedirs("../editor")
+    add_files("./*.cpp")
+    -- render paths are shared with the editor, only its window entry point is left out
+    add_files("../editor/applicationBase*.cpp")
+    add_deps("Engine")
+    add_deps("BuiltinResources")
+    add_packages("vulkansdk", "imgui", "spdlog", "glm")
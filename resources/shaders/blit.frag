@@ -1,11 +1,14 @@
 #version 460
 
+#extension GL_GOOGLE_include_directive : require
+
+#include "include/bindless.glsl"
+
 layout(location = 0) in vec2 texCoords;
-layout(binding = 3, rgba8) uniform coherent image2D colorBuffer; 
 
 layout(location = 0) out vec4 fragColor;
 
 void main()
 {
-    fragColor = imageLoad(colorBuffer, ivec2(texCoords * imageSize(colorBuffer)));
+    fragColor = imageLoad(colorBuffer, ivec2(texCoords * renderExtent));
 }
\ No newline at end of file
@@ -1,19 +1,12 @@
 #version 460
 
 #extension GL_ARB_fragment_shader_interlock : enable
-layout(early_fragment_tests) in;
-layout(pixel_interlock_ordered) in;
+#extension GL_GOOGLE_include_directive : require
 
-layout(set = 1, binding = 0, r32f) uniform coherent image2D ZBuffer[11];
-layout(set = 2, binding = 0) restrict readonly buffer VertexAttributes { vec4 pos[]; };
-layout(set = 2, binding = 2, r32f) uniform coherent image2D tempZBuffer;
+#include "include/bindless.glsl"
 
-layout(push_constant) uniform PushConstants 
-{
-    mat4 matrixVP; 
-    vec3 lightDirection;
-    uint mipLevelCount;
-};
+layout(early_fragment_tests) in;
+layout(pixel_interlock_ordered) in;
 
 layout(location = 0) out vec4 fragColor;
 
@@ -22,8 +15,7 @@ void main()
     ivec2 positionScreen = ivec2(gl_FragCoord.xy);
 
     // linearize depth
-    float z = gl_FragCoord.z * 2 - 1;
-    float linearDepth = (2 * .01f) / (1000.f + .01f - z * (1000.f - .01f)); 
+    float linearDepth = linearizeDepth(gl_FragCoord.z);
 
     beginInvocationInterlockARB();
 
@@ -40,9 +32,10 @@ void main()
 
     endInvocationInterlockARB();
 
-    const vec3 v0 = pos[3 * gl_PrimitiveID].xyz;
-    const vec3 v1 = pos[3 * gl_PrimitiveID + 1].xyz;
-    const vec3 v2 = pos[3 * gl_PrimitiveID + 2].xyz;
+    // primitives of the compacted draw keep the indices of their original face
+    const vec3 v0 = pos[indexOut[3 * gl_PrimitiveID]].xyz;
+    const vec3 v1 = pos[indexOut[3 * gl_PrimitiveID + 1]].xyz;
+    const vec3 v2 = pos[indexOut[3 * gl_PrimitiveID + 2]].xyz;
     const vec3 N = normalize(cross(v1 - v0, v2 - v1));
     fragColor = vec4(dot(N, lightDirection));
 }
\ No newline at end of file
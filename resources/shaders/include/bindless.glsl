@@ -0,0 +1,103 @@
+#ifndef BINDLESS_GLSL
+#define BINDLESS_GLSL
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+#include "shaderInterface.h"
+#include "pushConstants.glsl"
+
+struct ScanlineAttribute
+{
+    vec3 faceNormal;
+    float xStart;
+    float xEnd;
+    int y;
+    float zStart;
+    float dzdx;
+    uint faceIndex;
+};
+
+// every typed array aliases the same heap binding, slots are indexed through push constants
+layout(set = 0, binding = HEAP_STORAGE_IMAGE_BINDING, r32f) uniform coherent image2D r32fImageHeap[];
+layout(set = 0, binding = HEAP_STORAGE_IMAGE_BINDING, r32ui) uniform coherent uimage2D r32uiImageHeap[];
+layout(set = 0, binding = HEAP_STORAGE_IMAGE_BINDING, rgba8) uniform coherent image2D rgba8ImageHeap[];
+
+layout(set = 0, binding = HEAP_STORAGE_BUFFER_BINDING) coherent buffer ScanlineAttributes { ScanlineAttribute filledLines[]; } scanlineAttributesHeap[];
+layout(set = 0, binding = HEAP_STORAGE_BUFFER_BINDING) coherent buffer GlobalProperty { uvec3 workgroupCount; uint scanlineCount; uvec3 segmentWorkgroupCount; uint segmentCount; uvec3 sortWorkgroupCount; uint sortPass; } globalPropertyHeap[];
+layout(set = 0, binding = HEAP_STORAGE_BUFFER_BINDING) coherent buffer TileEntries { uint tileEntries[]; } tileEntriesHeap[];
+layout(set = 0, binding = HEAP_STORAGE_BUFFER_BINDING) coherent buffer SegmentOffsets { uint segmentOffsets[]; } segmentOffsetsHeap[];
+layout(set = 0, binding = HEAP_STORAGE_BUFFER_BINDING) coherent buffer SortPairs { uvec2 pairs[]; } sortPairsHeap[];
+layout(set = 0, binding = HEAP_STORAGE_BUFFER_BINDING) coherent buffer SortHistogram { uint sortHistogram[]; } sortHistogramHeap[];
+layout(set = 0, binding = HEAP_STORAGE_BUFFER_BINDING) coherent buffer IndirectBuffer { uint indexCount; uint instanceCount; uint firstIndex; int vertexOffset; uint firstInstance; } indirectBufferHeap[];
+
+/* named accessors keep shader bodies close to the old per-set declarations */
+#define ZBuffer(level) r32fImageHeap[imageHeapBase + SLOT_ZBUFFER_MIP + (level)]
+#define ZBufferMin(level) r32fImageHeap[imageHeapBase + SLOT_ZBUFFER_MIN_MIP + (level) - 1]
+#define historyZBuffer(level) r32fImageHeap[historyImageHeapBase + SLOT_ZBUFFER_MIP + (level)]
+#define spinlock r32uiImageHeap[imageHeapBase + SLOT_SPINLOCK]
+#define colorBuffer rgba8ImageHeap[imageHeapBase + SLOT_COLOR_BUFFER]
+#define tempZBuffer r32fImageHeap[imageHeapBase + SLOT_EMPTY_BUFFER]
+#define tileCounts r32uiImageHeap[imageHeapBase + SLOT_SCANLINE_TILE_COUNT]
+#define tileOffsets r32uiImageHeap[imageHeapBase + SLOT_SCANLINE_TILE_OFFSET]
+#define zBufferMipCounter r32uiImageHeap[imageHeapBase + SLOT_ZBUFFER_MIP_COUNTER]
+
+#define filledLines scanlineAttributesHeap[bufferHeapBase + SLOT_SCANLINE_BUFFER].filledLines
+#define tileEntries tileEntriesHeap[bufferHeapBase + SLOT_SCANLINE_TILE_ENTRIES].tileEntries
+#define segmentOffsets segmentOffsetsHeap[bufferHeapBase + SLOT_SCANLINE_SEGMENT_OFFSET].segmentOffsets
+#define sortPairs(i) sortPairsHeap[bufferHeapBase + SLOT_SORT_PAIRS + (i)].pairs
+#define sortHistogram sortHistogramHeap[bufferHeapBase + SLOT_SORT_HISTOGRAM].sortHistogram
+#define workgroupCount globalPropertyHeap[bufferHeapBase + SLOT_SCANLINE_GLOBAL_PROPERTY].workgroupCount
+#define scanlineCount globalPropertyHeap[bufferHeapBase + SLOT_SCANLINE_GLOBAL_PROPERTY].scanlineCount
+#define segmentWorkgroupCount globalPropertyHeap[bufferHeapBase + SLOT_SCANLINE_GLOBAL_PROPERTY].segmentWorkgroupCount
+#define segmentCount globalPropertyHeap[bufferHeapBase + SLOT_SCANLINE_GLOBAL_PROPERTY].segmentCount
+#define sortWorkgroupCount globalPropertyHeap[bufferHeapBase + SLOT_SCANLINE_GLOBAL_PROPERTY].sortWorkgroupCount
+#define sortPass globalPropertyHeap[bufferHeapBase + SLOT_SCANLINE_GLOBAL_PROPERTY].sortPass
+#define indexCount indirectBufferHeap[bufferHeapBase + SLOT_HIZ_INDIRECT].indexCount
+#define instanceCount indirectBufferHeap[bufferHeapBase + SLOT_HIZ_INDIRECT].instanceCount
+#define firstIndex indirectBufferHeap[bufferHeapBase + SLOT_HIZ_INDIRECT].firstIndex
+#define vertexOffset indirectBufferHeap[bufferHeapBase + SLOT_HIZ_INDIRECT].vertexOffset
+#define firstInstance indirectBufferHeap[bufferHeapBase + SLOT_HIZ_INDIRECT].firstInstance
+
+#define pos root.vertices.pos
+#define index root.indices.index
+#define triangleCount root.triangleCount
+#define renderExtent root.renderExtent
+#define depthRangeMin root.depthRangeMin
+#define depthRangeMax root.depthRangeMax
+#define nearPlane root.nearPlane
+#define farPlane root.farPlane
+#define indexOut root.outputIndices.indexOut
+#define octreeNodes root.octreeNodeList.nodes
+#define octreeFaces root.octreeFaceList.faces
+#define octreeNodeCount root.octreeNodeCount
+#define octreeLeafQueue root.octreeQueue.leafQueue
+#define octreeQueueHead root.octreeQueue.head
+#define octreeQueueTail root.octreeQueue.tail
+#define octreeQueueDone root.octreeQueue.done
+#define octreeQueueItems root.octreeQueue.items
+#define lbvhNodes root.lbvhNodeList.nodes
+#define lbvhLevel root.lbvhQueue.level
+#define lbvhNodeQueue(queue) root.lbvhQueue.nodeQueues[queue]
+#define lbvhSubtreeQueue root.lbvhQueue.subtreeQueue
+#define lbvhQueueItems root.lbvhQueue.items
+#define hiZRejectedDispatch root.hiZRejected.dispatchSize
+#define hiZRejectedCount root.hiZRejected.faceCount
+#define hiZRejectedFaces root.hiZRejected.faces
+#define historyImageHeapBase root.historyImageHeapBase
+#define historyValid root.historyValid
+#define historyMatrixVP root.historyMatrixVP
+#define clusterCount root.clusterCount
+#define faceClusters root.faceClusters.clusters
+#define hiZVisibleDispatch root.hiZVisible.dispatchSize
+#define hiZVisibleCount root.hiZVisible.visibleCount
+#define hiZVisibleClusters root.hiZVisible.clusters
+#define cameraPosition root.cameraPosition
+
+// linear depth stored by every z-buffer, from a window depth of the camera projection
+float linearizeDepth(float windowDepth)
+{
+    const float z = windowDepth * 2 - 1;
+    return (2 * nearPlane) / (farPlane + nearPlane - z * (farPlane - nearPlane));
+}
+
+#endif
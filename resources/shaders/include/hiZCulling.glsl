@@ -0,0 +1,118 @@
+#ifndef HIZ_CULLING_GLSL
+#define HIZ_CULLING_GLSL
+
+#include "bindless.glsl"
+
+// min & max linear depth of a z-buffer texel, mip 0 holds a single depth
+vec2 hiZTexelBounds(uint level, ivec2 coord)
+{
+    const float maxDepth = imageLoad(ZBuffer(level), coord).x;
+    return vec2(level == 0 ? maxDepth : imageLoad(ZBufferMin(level), coord).x, maxDepth);
+}
+
+// depth bounds of a screen rect, the level must be coarse enough for the rect to span at most 2x2 texels
+vec2 hiZRegionBounds(uint level, ivec2 minCoord, ivec2 maxCoord)
+{
+    const ivec4 coords = ivec4(minCoord, maxCoord) >> level;
+    const vec2 bounds0 = hiZTexelBounds(level, coords.xy), bounds1 = hiZTexelBounds(level, coords.zw);
+    const vec2 bounds2 = hiZTexelBounds(level, coords.xw), bounds3 = hiZTexelBounds(level, coords.zy);
+    return vec2(min(min(bounds0.x, bounds1.x), min(bounds2.x, bounds3.x)), max(max(bounds0.y, bounds1.y), max(bounds2.y, bounds3.y)));
+}
+
+// level where a screen rect spans at most 2x2 texels, i.e. ceil(log2(size))
+uint hiZLevel(ivec2 minCoord, ivec2 maxCoord)
+{
+    const ivec2 boxSize = maxCoord - minCoord + 1;
+    return min(uint(findMSB(max(boxSize.x, boxSize.y) - 1) + 1), mipLevelCount - 1);
+}
+
+// screen space corners of a face, xy in pixels and z in window depth
+// false when a corner is behind the camera, its projection is meaningless then
+bool hiZProjectFace(const mat4 viewProjection, const mat3x4 matrixVert, out mat3 matrixScreen)
+{
+    const mat3x4 matrixClip = viewProjection * matrixVert;
+    if(min(matrixClip[0].w, min(matrixClip[1].w, matrixClip[2].w)) <= .0f)
+        return false;
+    for(int i = 0; i < 3; ++i)
+        matrixScreen[i] = vec3((matrixClip[i].xy / matrixClip[i].w * .5f + .5f) * vec2(renderExtent), matrixClip[i].z / matrixClip[i].w);
+    return true;
+}
+
+// screen space bounds of a world space box, false when all its corners are outside one same frustum plane
+// a box crossing the camera plane has no meaningful projection, it is bounded by the whole screen from the near plane on
+bool hiZProjectBox(const mat4 viewProjection, vec3 minPoint, vec3 maxPoint, out vec3 minBound, out vec3 maxBound)
+{
+    minBound = vec3(uintBitsToFloat(0x7F7FFFFFU));
+    maxBound = -minBound;
+    uint outside = 0x3FU;
+    bool crossing = false;
+    for(uint i = 0; i < 8; ++i)
+    {
+        const vec4 clip = viewProjection * vec4((i & 1U) != 0 ? maxPoint.x : minPoint.x,
+                                                (i & 2U) != 0 ? maxPoint.y : minPoint.y,
+                                                (i & 4U) != 0 ? maxPoint.z : minPoint.z, 1.f);
+        outside &= (clip.x < -clip.w ? 0x1U : 0U) | (clip.x > clip.w ? 0x2U : 0U) |
+                   (clip.y < -clip.w ? 0x4U : 0U) | (clip.y > clip.w ? 0x8U : 0U) |
+                   (clip.z < .0f ? 0x10U : 0U) | (clip.z > clip.w ? 0x20U : 0U);
+        crossing = crossing || clip.w <= .0f;
+        const vec3 screen = vec3((clip.xy / clip.w * .5f + .5f) * vec2(renderExtent), clip.z / clip.w);
+        minBound = min(minBound, screen);
+        maxBound = max(maxBound, screen);
+    }
+    if(crossing)
+    {
+        minBound = vec3(0);
+        maxBound = vec3(vec2(renderExtent), 1.f);
+    }
+    return outside == 0;
+}
+
+// conservative test of a screen space box, xy in pixels and z in window depth
+// false only when the whole box is behind the z-buffer
+bool hiZVisible(vec3 minBound, vec3 maxBound)
+{
+    // the part of the box off screen can not be seen anyway
+    const ivec2 minCoord = clamp(ivec2(minBound.xy), ivec2(0), ivec2(renderExtent) - 1);
+    const ivec2 maxCoord = clamp(ivec2(maxBound.xy), ivec2(0), ivec2(renderExtent) - 1);
+    const uint level = hiZLevel(minCoord, maxCoord);
+
+    const float minDepth = linearizeDepth(clamp(minBound.z, .0f, 1.f));
+    const float maxDepth = linearizeDepth(clamp(maxBound.z, .0f, 1.f));
+    const vec2 region = hiZRegionBounds(level, minCoord, maxCoord);
+    // in front of everything drawn in the region
+    if(maxDepth < region.x)
+        return true;
+    // behind everything drawn in the region
+    if(minDepth > region.y)
+        return false;
+    if(level == 0)
+        return true;
+
+    // straddling the region, the texels of one finer level may still hide the whole box
+    const ivec2 first = minCoord >> (level - 1), last = maxCoord >> (level - 1);
+    for(int y = first.y; y <= last.y; ++y)
+        for(int x = first.x; x <= last.x; ++x)
+            if(minDepth <= imageLoad(ZBuffer(level - 1), ivec2(x, y)).x)
+                return true;
+    return false;
+}
+
+// same box test against the max pyramid of the previous frame, the box is projected with its view projection
+// only texels of one level finer are compared, the min pyramid does not outlive its frame
+bool hiZHistoryVisible(vec3 minBound, vec3 maxBound)
+{
+    const ivec2 minCoord = clamp(ivec2(minBound.xy), ivec2(0), ivec2(renderExtent) - 1);
+    const ivec2 maxCoord = clamp(ivec2(maxBound.xy), ivec2(0), ivec2(renderExtent) - 1);
+    const uint level = hiZLevel(minCoord, maxCoord);
+    const uint fineLevel = level > 0 ? level - 1 : 0;
+
+    const float minDepth = linearizeDepth(clamp(minBound.z, .0f, 1.f));
+    const ivec2 first = minCoord >> fineLevel, last = maxCoord >> fineLevel;
+    for(int y = first.y; y <= last.y; ++y)
+        for(int x = first.x; x <= last.x; ++x)
+            if(minDepth <= imageLoad(historyZBuffer(fineLevel), ivec2(x, y)).x)
+                return true;
+    return false;
+}
+
+#endif
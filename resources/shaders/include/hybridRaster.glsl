@@ -0,0 +1,79 @@
+#ifndef HYBRID_RASTER_GLSL
+#define HYBRID_RASTER_GLSL
+
+// classification & software rasterization of the hybrid visibility buffer
+// define VISIBILITY_BUFFER_64 before including, the packing follows visibilityBuffer.glsl
+
+#include "hiZCulling.glsl"
+#include "visibilityBuffer.glsl"
+#include "subgroupAllocate.glsl"
+
+// twice the signed area of the triangle a, b, p
+float hybridEdge(vec2 a, vec2 b, vec2 p)
+{
+    return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+// pixel centers inside the bounds are tested against the three edges, the way the hardware samples them
+// shared edges are inclusive, a pixel covered twice keeps the nearer face or the lower id anyway
+void hybridRasterFace(uint triangleIndex, const mat3 matrixScreen, vec3 minBound, vec3 maxBound)
+{
+    const vec2 a = matrixScreen[0].xy, b = matrixScreen[1].xy, c = matrixScreen[2].xy;
+    const float area = hybridEdge(a, b, c);
+    if(area == .0f)
+        return;
+
+    const ivec2 minCoord = max(ivec2(ceil(minBound.xy - .5f)), ivec2(0));
+    const ivec2 maxCoord = min(ivec2(floor(maxBound.xy - .5f)), ivec2(renderExtent) - 1);
+    for(int y = minCoord.y; y <= maxCoord.y; ++y)
+        for(int x = minCoord.x; x <= maxCoord.x; ++x)
+        {
+            const vec2 p = vec2(x, y) + .5f;
+            const vec3 barycentric = vec3(hybridEdge(b, c, p), hybridEdge(c, a, p), hybridEdge(a, b, p)) / area;
+            if(any(lessThan(barycentric, vec3(0))))
+                continue;
+            // window depth is affine in screen space
+            const float depth = dot(barycentric, vec3(matrixScreen[0].z, matrixScreen[1].z, matrixScreen[2].z));
+            imageAtomicMin(visibilityBuffer, ivec2(x, y), packVisibility(linearizeDepth(depth), triangleIndex));
+        }
+}
+
+// each thread handles one triangle face: small ones are rasterized right here,
+// large ones are compacted for the hardware path, which draws them into the same visibility buffer
+void hybridRasterMain()
+{
+    if(gl_GlobalInvocationID.x >= triangleCount) return;
+
+    const uint triangleIndex = gl_GlobalInvocationID.x;
+    const uvec3 faceIndex = uvec3(index[3 * triangleIndex + 0], index[3 * triangleIndex + 1], index[3 * triangleIndex + 2]);
+    const mat3x4 matrixVert = mat3x4(pos[faceIndex.x], pos[faceIndex.y], pos[faceIndex.z]);
+
+    // faces crossing the camera plane are left to the clipper of the hardware path
+    bool large = true;
+    mat3 matrixScreen;
+    if(hiZProjectFace(matrixVP, matrixVert, matrixScreen))
+    {
+        const vec3 minBound = min(matrixScreen[0], min(matrixScreen[1], matrixScreen[2]));
+        const vec3 maxBound = max(matrixScreen[0], max(matrixScreen[1], matrixScreen[2]));
+        const vec3 normal = cross(matrixScreen[1] - matrixScreen[0], matrixScreen[2] - matrixScreen[1]);
+        // back facing and off screen faces are dropped on both paths, the hardware one culls back faces as well
+        const bool culled = normal.z > .0f || any(lessThan(maxBound.xy, vec2(0))) || any(greaterThanEqual(minBound.xy, vec2(renderExtent)));
+        large = !culled && any(greaterThan(maxBound.xy - minBound.xy, vec2(HYBRID_SMALL_FACE_EXTENT)));
+        if(!culled && !large)
+            hybridRasterFace(triangleIndex, matrixScreen, minBound, maxBound);
+    }
+
+    // allocated outside the branches, so that every face takes part in the subgroup allocation, small & dropped ones with a count of 0
+    uint offset, subgroupTotal, subgroupBase;
+    SUBGROUP_ATOMIC_ADD(indexCount, large ? 3U : 0U, offset, subgroupTotal, subgroupBase);
+    if(large)
+    {
+        indexOut[offset] = faceIndex.x;
+        indexOut[offset + 1] = faceIndex.y;
+        indexOut[offset + 2] = faceIndex.z;
+        // primitive i of the compacted draw is face hiZRejectedFaces[i] of the model
+        hiZRejectedFaces[offset / 3] = triangleIndex;
+    }
+}
+
+#endif
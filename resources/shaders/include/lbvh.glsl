@@ -0,0 +1,64 @@
+#ifndef LBVH_GLSL
+#define LBVH_GLSL
+
+#include "hiZCulling.glsl"
+#include "subgroupAllocate.glsl"
+
+// linear bvh of lbvh hi-z, rebuilt every frame from the morton codes sorted into sortPairs(0)
+// internal nodes come first and leaf i right after them, so the root is node 0 even for a single face
+#define LBVH_NO_NODE 0xFFFFFFFFU
+#define lbvhNodeQueueItem(queue, i) lbvhQueueItems[(queue) * triangleCount + (i)]
+#define lbvhSubtreeQueueItem(i) lbvhQueueItems[2 * triangleCount + (i)]
+
+uint lbvhLeaf(uint sortedIndex)
+{
+    return triangleCount - 1 + sortedIndex;
+}
+
+bool lbvhIsLeaf(uint node)
+{
+    return node >= triangleCount - 1;
+}
+
+// an inner node is culled as a whole when its bounds are outside the frustum or behind the z-buffer
+bool lbvhNodeVisible(const BvhNode node)
+{
+    vec3 minBound, maxBound;
+    return hiZProjectBox(matrixVP, node.minPoint.xyz, node.maxPoint.xyz, minBound, maxBound) && hiZVisible(minBound, maxBound);
+}
+
+// leaves are tested as faces, with the same back face, subpixel & hi-z tests as the other modes, survivors go to the draw
+// called by inner nodes too, with candidate false, so that every invocation takes part in the subgroup allocation
+void lbvhEmitFace(uint triangleIndex, bool candidate)
+{
+    uvec3 faceIndex = uvec3(0);
+    bool visible = candidate;
+    if(candidate)
+    {
+        faceIndex = uvec3(index[3 * triangleIndex + 0], index[3 * triangleIndex + 1], index[3 * triangleIndex + 2]);
+        const mat3x4 matrixVert = mat3x4(pos[faceIndex.x], pos[faceIndex.y], pos[faceIndex.z]);
+
+        // faces crossing the camera plane have no screen bounds, they are simply kept
+        mat3 matrixScreen;
+        if(hiZProjectFace(matrixVP, matrixVert, matrixScreen))
+        {
+            const vec3 minBound = min(matrixScreen[0], min(matrixScreen[1], matrixScreen[2]));
+            const vec3 maxBound = max(matrixScreen[0], max(matrixScreen[1], matrixScreen[2]));
+            const vec3 normal = cross(matrixScreen[1] - matrixScreen[0], matrixScreen[2] - matrixScreen[1]);
+            visible = !(int(minBound.x) == int(maxBound.x) || int(minBound.y) == int(maxBound.y) || normal.z > .0f ||
+                        any(lessThan(maxBound.xy, vec2(0))) || any(greaterThanEqual(minBound.xy, vec2(renderExtent)))) &&
+                      hiZVisible(minBound, maxBound);
+        }
+    }
+
+    uint offset, subgroupTotal, subgroupBase;
+    SUBGROUP_ATOMIC_ADD(indexCount, visible ? 3U : 0U, offset, subgroupTotal, subgroupBase);
+    if(visible)
+    {
+        indexOut[offset] = faceIndex.x;
+        indexOut[offset + 1] = faceIndex.y;
+        indexOut[offset + 2] = faceIndex.z;
+    }
+}
+
+#endif
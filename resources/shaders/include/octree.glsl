@@ -0,0 +1,33 @@
+#ifndef OCTREE_GLSL
+#define OCTREE_GLSL
+
+#include "hiZCulling.glsl"
+
+// object space octree of optim hi-z, built once with the model by buildFaceOctree in modelLoader.hpp
+// the items of OctreeQueues hold the work queue of octreeNodeCount slots, then the leaf queue
+// slots not pushed yet hold OCTREE_NO_NODE, the reset fills them every frame
+// a slot given up by its invocation holds OCTREE_ABANDONED, whoever pushes into it queues the node as a leaf
+#define OCTREE_NO_NODE 0xFFFFFFFFU
+#define OCTREE_ABANDONED 0xFFFFFFFEU
+#define octreeQueueSlot(i) octreeQueueItems[i]
+#define octreeLeafQueueItem(i) octreeQueueItems[octreeNodeCount + (i)]
+
+// visible leaves culled by one workgroup of octreeLeafCulling.comp
+const uint octreeLeavesPerWorkgroup = 1024 / OCTREE_LEAF_SIZE;
+
+// the faces of a node are contiguous, so an inner node can be queued as a leaf too, all its faces are tested then
+void octreeQueueLeaf(uint nodeIndex)
+{
+    const uint leafSlot = atomicAdd(octreeLeafQueue.w, 1U);
+    atomicMax(octreeLeafQueue.x, leafSlot / octreeLeavesPerWorkgroup + 1);
+    octreeLeafQueueItem(leafSlot) = nodeIndex;
+}
+
+// a node is culled as a whole when its refit bounds are outside the frustum or behind the z-buffer
+bool octreeNodeVisible(const OctreeNode node)
+{
+    vec3 minBound, maxBound;
+    return hiZProjectBox(matrixVP, node.minPoint.xyz, node.maxPoint.xyz, minBound, maxBound) && hiZVisible(minBound, maxBound);
+}
+
+#endif
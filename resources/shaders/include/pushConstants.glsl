@@ -0,0 +1,19 @@
+#ifndef PUSH_CONSTANTS_GLSL
+#define PUSH_CONSTANTS_GLSL
+
+#include "rootBuffer.glsl"
+
+// keep in sync with PushConstants in applicationBase.hpp
+layout(push_constant) uniform PushConstants
+{
+    mat4 matrixVP;
+    vec3 lightDirection;
+    uint mipLevelCount;
+    vec4 minBoundWorld;
+    vec4 maxBoundWorld;
+    uint imageHeapBase;
+    uint bufferHeapBase;
+    RootBuffer root;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef RADIX_SORT_GLSL
+#define RADIX_SORT_GLSL
+
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_ballot : require
+
+#include "bindless.glsl"
+
+// least significant digit radix sort of (key, scanline index) pairs, one digit per pass: histogram, scan, scatter
+// pairs ping-pong between the two sort buffers, after an even pass count the result is back in the first one
+#if RADIX_SORT_BLOCK_SIZE != (1 << RADIX_SORT_DIGIT_BITS)
+#error every invocation of a block owns one digit value
+#endif
+
+#define sortSource sortPairs(sortPass & 1U)
+#define sortDestination sortPairs((sortPass & 1U) ^ 1U)
+
+uint sortKeyCount()
+{
+    return min(scanlineCount, min(uint(filledLines.length()), uint(sortPairs(0).length())));
+}
+
+uint sortBlockCount()
+{
+    return (sortKeyCount() + RADIX_SORT_BLOCK_SIZE - 1) / RADIX_SORT_BLOCK_SIZE;
+}
+
+uint sortDigit(uint key)
+{
+    return (key >> (sortPass * RADIX_SORT_DIGIT_BITS)) & ((1U << RADIX_SORT_DIGIT_BITS) - 1U);
+}
+
+// subgroups take consecutive runs of the block, so that ranks inside a subgroup follow the key order
+uint sortKeyIndex()
+{
+    return gl_WorkGroupID.x * RADIX_SORT_BLOCK_SIZE + gl_SubgroupID * gl_SubgroupSize + gl_SubgroupInvocationID;
+}
+
+// first sorted pair whose key is not less than key
+uint sortedLowerBound(uint key, uint keyCount)
+{
+    uint low = 0, high = keyCount;
+    while(low < high)
+    {
+        const uint middle = (low + high) / 2;
+        if(sortPairs(0)[middle].x < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+#endif
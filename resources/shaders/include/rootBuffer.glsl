@@ -0,0 +1,80 @@
+#ifndef ROOT_BUFFER_GLSL
+#define ROOT_BUFFER_GLSL
+
+#extension GL_EXT_buffer_reference : require
+
+// buffers reached by device address, so swapping geometry never touches descriptors
+layout(buffer_reference, std430, buffer_reference_align = 16) restrict readonly buffer VertexAttributes { vec4 pos[]; };
+layout(buffer_reference, std430, buffer_reference_align = 4) restrict readonly buffer Indices { uint index[]; };
+layout(buffer_reference, std430, buffer_reference_align = 4) coherent buffer OutputIndices { uint indexOut[]; };
+layout(buffer_reference, std430, buffer_reference_align = 16) coherent buffer RejectedFaces { uvec3 dispatchSize; uint faceCount; uint faces[]; };
+layout(buffer_reference, std430, buffer_reference_align = 16) coherent buffer VisibleClusters { uvec3 dispatchSize; uint visibleCount; uint clusters[]; };
+
+// keep in sync with FaceCluster in modelLoader.hpp
+struct FaceCluster
+{
+    vec4 minPoint;
+    vec4 maxPoint;
+    vec4 cone; // average normal & sine of the largest angle to it
+};
+layout(buffer_reference, std430, buffer_reference_align = 16) restrict readonly buffer FaceClusters { FaceCluster clusters[]; };
+
+// keep in sync with FaceOctreeNode in modelLoader.hpp
+struct OctreeNode
+{
+    vec4 minPoint;
+    vec4 maxPoint;
+    uint firstChild; // children are contiguous
+    uint childCount; // 0 for leaves
+    uint firstFace; // range of the sorted faces below the node
+    uint faceCount;
+};
+layout(buffer_reference, std430, buffer_reference_align = 16) restrict readonly buffer OctreeNodes { OctreeNode nodes[]; };
+layout(buffer_reference, std430, buffer_reference_align = 4) restrict readonly buffer OctreeFaces { uint faces[]; };
+// one work queue where every node is pushed at most once, then the visible leaves
+// xyz of the leaf header is the indirect dispatch size of the face pass, w the leaf count
+layout(buffer_reference, std430, buffer_reference_align = 16) coherent buffer OctreeQueues { uvec4 leafQueue; uint head; uint tail; uint done; uint items[]; };
+
+// triangleCount - 1 internal nodes, then one leaf per face in morton order, the root is node 0
+struct BvhNode
+{
+    vec4 minPoint; // w is the face count of the subtree, summed by the refit
+    vec4 maxPoint;
+    uint left; // face index for leaves
+    uint right;
+    uint parent;
+    uint refitVisits; // the second child to finish its refit goes on to the parent
+};
+layout(buffer_reference, std430, buffer_reference_align = 16) coherent buffer BvhNodes { BvhNode nodes[]; };
+// two node queues of triangleCount entries, ping-ponged between the breadth first levels, then the subtrees left for the depth first walk
+layout(buffer_reference, std430, buffer_reference_align = 16) coherent buffer BvhQueues { uvec4 nodeQueues[2]; uvec4 subtreeQueue; uint level; uint items[]; };
+
+// keep in sync with RootBufferData in applicationBase.hpp
+layout(buffer_reference, std430, buffer_reference_align = 16) restrict readonly buffer RootBuffer
+{
+    VertexAttributes vertices;
+    Indices indices;
+    OutputIndices outputIndices;
+    OctreeFaces octreeFaceList;
+    RejectedFaces hiZRejected;
+    FaceClusters faceClusters;
+    VisibleClusters hiZVisible;
+    OctreeNodes octreeNodeList;
+    OctreeQueues octreeQueue;
+    BvhNodes lbvhNodeList;
+    BvhQueues lbvhQueue;
+    uvec2 renderExtent; // render targets are pooled with a rounded up size, only this sub-rect is in use
+    uint triangleCount;
+    uint clusterCount;
+    uint octreeNodeCount;
+    float depthRangeMin; // linear depth range of the model in view, rewritten every frame
+    float depthRangeMax;
+    float nearPlane; // clip planes of the camera, rewritten every frame
+    float farPlane;
+    uint historyImageHeapBase; // temporal hi-z reads the pyramid of the previous frame through its heap slots
+    uint historyValid;
+    mat4 historyMatrixVP; // view projection the previous frame was rendered with
+    vec4 cameraPosition;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef SCANLINE_PAINTER_GLSL
+#define SCANLINE_PAINTER_GLSL
+
+#include "scanlineSegments.glsl"
+
+// painter's scanline keys: row in the high bits, then the far depth of the span inverted, so an ascending sort
+// groups spans by row and orders every row back to front
+// spans outside the render extent get the row just past it, so they sort after every visible row
+
+float scanlineLinearDepth(const ScanlineAttribute scanline, int x)
+{
+    return linearizeDepth(scanline.zStart + scanline.dzdx * (x - int(scanline.xStart)));
+}
+
+uint painterDepthBits()
+{
+    return 32U - uint(findMSB(renderExtent.y) + 1);
+}
+
+uint painterRowKey(uint row)
+{
+    return row << painterDepthBits();
+}
+
+uint painterKey(const ScanlineAttribute scanline)
+{
+    const ivec2 span = clippedSpan(scanline);
+    if(span.x > span.y)
+        return painterRowKey(renderExtent.y);
+
+    // depth is linear along the span, so its far end is one of the two ends, quantized over the depth range of the model
+    const uint depthBits = painterDepthBits();
+    const float farDepth = max(scanlineLinearDepth(scanline, span.x), scanlineLinearDepth(scanline, span.y));
+    const float normalizedDepth = clamp((farDepth - depthRangeMin) / max(depthRangeMax - depthRangeMin, 1e-20f), .0f, 1.f);
+    const uint maxDepth = (1U << depthBits) - 1U;
+    return painterRowKey(uint(scanline.y)) | (maxDepth - uint(normalizedDepth * float(maxDepth)));
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef SCANLINE_SEGMENTS_GLSL
+#define SCANLINE_SEGMENTS_GLSL
+
+#include "bindless.glsl"
+
+// spans are split into segments of SCANLINE_SEGMENT_WIDTH pixels, one thread each, so a long span no longer stalls its workgroup
+// init writes the segment count of every scanline, the segment scan turns them into exclusive offsets
+
+// pixel range of a span clipped to the render extent, empty when x > y
+ivec2 clippedSpan(const ScanlineAttribute scanline)
+{
+    if(scanline.y < 0 || scanline.y >= int(renderExtent.y))
+        return ivec2(0, -1);
+    return ivec2(max(int(scanline.xStart), 0), min(int(scanline.xEnd), int(renderExtent.x) - 1));
+}
+
+uint spanSegmentCount(const ScanlineAttribute scanline)
+{
+    const ivec2 span = clippedSpan(scanline);
+    return span.x > span.y ? 0U : uint(span.y - span.x + SCANLINE_SEGMENT_WIDTH) / SCANLINE_SEGMENT_WIDTH;
+}
+
+uint segmentScanlineCount()
+{
+    return min(scanlineCount, min(uint(filledLines.length()), uint(segmentOffsets.length())));
+}
+
+// the owning scanline is the last one whose first segment is not past the segment, found by binary search over the offsets
+bool findSegment(uint segment, out uint scanlineIndex, out ivec2 pixelRange)
+{
+    if(segment >= segmentCount)
+        return false;
+
+    uint low = 0, high = segmentScanlineCount() - 1;
+    while(low < high)
+    {
+        const uint middle = (low + high + 1) / 2;
+        if(segmentOffsets[middle] <= segment)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    scanlineIndex = low;
+    const ivec2 span = clippedSpan(filledLines[low]);
+    const int xBegin = span.x + int(segment - segmentOffsets[low]) * SCANLINE_SEGMENT_WIDTH;
+    pixelRange = ivec2(xBegin, min(xBegin + SCANLINE_SEGMENT_WIDTH - 1, span.y));
+    return true;
+}
+
+#endif
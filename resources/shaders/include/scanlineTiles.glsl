@@ -0,0 +1,25 @@
+#ifndef SCANLINE_TILES_GLSL
+#define SCANLINE_TILES_GLSL
+
+#include "bindless.glsl"
+
+// a scanline covers a single row, so it falls into one tile row and a run of tiles along x
+// returns false when the scanline lies outside the render extent
+bool scanlineTileRange(const ScanlineAttribute scanline, out ivec2 firstTile, out int lastTileX)
+{
+    const int xBegin = max(int(scanline.xStart), 0);
+    const int xEnd = min(int(scanline.xEnd), int(renderExtent.x) - 1);
+    if(scanline.y < 0 || scanline.y >= int(renderExtent.y) || xBegin > xEnd)
+        return false;
+
+    firstTile = ivec2(xBegin, scanline.y) / SCANLINE_TILE_SIZE;
+    lastTileX = xEnd / SCANLINE_TILE_SIZE;
+    return true;
+}
+
+uvec2 tileGridSize()
+{
+    return (renderExtent + SCANLINE_TILE_SIZE - 1) / SCANLINE_TILE_SIZE;
+}
+
+#endif
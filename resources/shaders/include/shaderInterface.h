@@ -0,0 +1,64 @@
+#ifndef SHADER_INTERFACE_H
+#define SHADER_INTERFACE_H
+
+// shared by C++ and GLSL, so only plain macros are allowed here
+
+/* descriptor heap layout, must match DescriptorHeap */
+#define HEAP_STORAGE_IMAGE_BINDING 0
+#define HEAP_STORAGE_BUFFER_BINDING 1
+#define HEAP_MAX_STORAGE_IMAGE_COUNT 256
+#define HEAP_MAX_STORAGE_BUFFER_COUNT 64
+
+/* storage image slots, relative to PushConstants.imageHeapBase */
+#define MAX_ZBUFFER_MIP_COUNT 16 // max resolution to 32768
+#define SLOT_ZBUFFER_MIP 0
+#define SLOT_SPINLOCK 16
+#define SLOT_COLOR_BUFFER 17
+#define SLOT_EMPTY_BUFFER 18
+#define SLOT_VISIBILITY_BUFFER 19
+#define SLOT_SCANLINE_TILE_COUNT 20
+#define SLOT_SCANLINE_TILE_OFFSET 21
+#define SLOT_ZBUFFER_MIP_COUNTER 22 // 1x1, workgroups of the z-buffer downsampler that are done
+#define SLOT_ZBUFFER_MIN_MIP 40 // min depth pyramid from mip 1 on, mip 0 is the z-buffer itself
+#define IMAGE_SLOTS_PER_FRAME 64
+
+/* storage buffer slots, relative to PushConstants.bufferHeapBase */
+// geometry and model sized buffers are reached through the root buffer instead
+#define SLOT_SCANLINE_BUFFER 0
+#define SLOT_SCANLINE_GLOBAL_PROPERTY 1
+#define SLOT_HIZ_INDIRECT 2
+#define SLOT_SCANLINE_TILE_ENTRIES 3
+#define SLOT_SCANLINE_SEGMENT_OFFSET 4
+#define SLOT_SORT_PAIRS 5 // two slots, sorting ping-pongs between them
+#define SLOT_SORT_HISTOGRAM 7
+#define BUFFER_SLOTS_PER_FRAME 8
+
+/* tiled scanline z-buffer */
+#define SCANLINE_TILE_SIZE 16 // one workgroup resolves a square tile of this size
+
+/* scanline work load balancing */
+#define SCANLINE_SEGMENT_WIDTH 16 // pixels filled by one thread, spans are split into segments of this width
+
+/* radix sort */
+#define RADIX_SORT_DIGIT_BITS 8
+#define RADIX_SORT_PASS_COUNT 4 // 32 bits keys
+#define RADIX_SORT_BLOCK_SIZE 256 // keys per workgroup, one per invocation and as many as digit values
+
+/* object space octree of optim hi-z, built once per model */
+#define OCTREE_LEAF_SIZE 64 // octants with more faces are split, one slice of this many threads culls the faces of a leaf
+#define OCTREE_MAX_DEPTH 21 // morton codes of face centroids use 3 bits per level, 63 bits in all
+#define OCTREE_TRAVERSAL_WORKGROUP_COUNT 64 // persistent workgroups of 64 invocations, few enough to be resident together
+#define OCTREE_TRAVERSAL_MAX_ITERATIONS 65536 // per invocation, past it the node of the claimed slot is culled by its faces instead
+
+/* lbvh of lbvh hi-z, rebuilt every frame */
+#define LBVH_SUBTREE_FACE_COUNT 64 // visible nodes with at most this many faces leave the breadth first frontier, one invocation walks each
+#define LBVH_MAX_FRONTIER_LEVELS 59 // a node of more faces has 7 levels below it and no leaf is deeper than 64, so its children are at most 58 deep
+#define LBVH_STACK_SIZE 64 // 30 bits morton codes, tied ones split by 32 bits face indices, bound the depth
+
+/* hybrid visibility buffer */
+#define HYBRID_SMALL_FACE_EXTENT 8 // faces whose screen bounds are at most this many pixels wide & high are rasterized in compute
+
+/* hi-z cluster culling */
+#define HIZ_CLUSTER_SIZE 64 // consecutive faces culled as a whole before the per face test
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef SUBGROUP_ALLOCATE_GLSL
+#define SUBGROUP_ALLOCATE_GLSL
+
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_arithmetic : require
+#extension GL_KHR_shader_subgroup_ballot : require
+
+// atomicAdd(counter, count) aggregated over the active invocations of a subgroup, so the counter sees one atomic per subgroup
+// every invocation gets its own range, in invocation order; invocations allocating nothing pass a count of 0
+// a macro since glsl cannot pass buffer members by reference, subgroupTotal & subgroupBase are left for follow-up atomics
+#define SUBGROUP_ATOMIC_ADD(counter, count, offset, subgroupTotal, subgroupBase) \
+    { \
+        subgroupTotal = subgroupAdd(count); \
+        subgroupBase = 0; \
+        if(subgroupElect() && subgroupTotal > 0) \
+            subgroupBase = atomicAdd(counter, subgroupTotal); \
+        subgroupBase = subgroupBroadcastFirst(subgroupBase); \
+        offset = subgroupBase + subgroupExclusiveAdd(count); \
+    }
+
+#endif
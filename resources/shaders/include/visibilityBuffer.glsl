@@ -0,0 +1,51 @@
+#ifndef VISIBILITY_BUFFER_GLSL
+#define VISIBILITY_BUFFER_GLSL
+
+// depth & primitive id packed into one value, so a single atomic min resolves visibility without pixel interlock
+// define VISIBILITY_BUFFER_64 before including to pack into 64 bits, which needs image int64 atomics
+// the 32 bits fallback splits the bits between a primitive id wide enough for the model and a depth quantized over its depth range
+
+#include "bindless.glsl"
+
+#ifdef VISIBILITY_BUFFER_64
+layout(set = 0, binding = HEAP_STORAGE_IMAGE_BINDING, r64ui) uniform coherent u64image2D r64uiImageHeap[];
+#define visibilityBuffer r64uiImageHeap[imageHeapBase + SLOT_VISIBILITY_BUFFER]
+#define VisibilityValue uint64_t
+// cleared to all ones, no primitive covers the pixel
+const uint64_t emptyVisibility = ~0UL;
+#else
+#define visibilityBuffer r32uiImageHeap[imageHeapBase + SLOT_VISIBILITY_BUFFER]
+#define VisibilityValue uint
+const uint emptyVisibility = ~0U;
+#endif
+
+uint primitiveIdBits()
+{
+    return findMSB(max(triangleCount, 2U) - 1U) + 1U;
+}
+
+VisibilityValue packVisibility(float linearDepth, uint primitiveId)
+{
+#ifdef VISIBILITY_BUFFER_64
+    // positive floats keep their order as unsigned integers
+    return (uint64_t(floatBitsToUint(linearDepth)) << 32) | uint64_t(primitiveId);
+#else
+    const uint idBits = primitiveIdBits();
+    const uint depthBits = 32U - idBits;
+    // the largest quantized depth is left out, so that no packed value collides with emptyVisibility
+    const float normalizedDepth = clamp((linearDepth - depthRangeMin) / max(depthRangeMax - depthRangeMin, 1e-20f), .0f, 1.f);
+    const uint quantizedDepth = uint(normalizedDepth * float((1U << depthBits) - 2U));
+    return (quantizedDepth << idBits) | primitiveId;
+#endif
+}
+
+uint unpackPrimitiveId(VisibilityValue value)
+{
+#ifdef VISIBILITY_BUFFER_64
+    return uint(value & 0xFFFFFFFFUL);
+#else
+    return value & ((1U << primitiveIdBits()) - 1U);
+#endif
+}
+
+#endif
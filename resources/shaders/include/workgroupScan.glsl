@@ -0,0 +1,39 @@
+#ifndef WORKGROUP_SCAN_GLSL
+#define WORKGROUP_SCAN_GLSL
+
+// single 1D workgroup prefix sum in shared memory, used by passes that scan a whole buffer in one workgroup
+// each invocation first sums a contiguous chunk, the chunk sums are scanned here, then chunks are rewritten from their offsets
+#ifndef WORKGROUP_SCAN_SIZE
+#define WORKGROUP_SCAN_SIZE 1024
+#endif
+
+shared uint workgroupScanSums[WORKGROUP_SCAN_SIZE];
+
+// contiguous range of items summed by the calling invocation
+uvec2 workgroupScanChunk(uint itemCount)
+{
+    const uint chunkSize = (itemCount + WORKGROUP_SCAN_SIZE - 1) / WORKGROUP_SCAN_SIZE;
+    const uint chunkBegin = min(gl_LocalInvocationIndex * chunkSize, itemCount);
+    return uvec2(chunkBegin, min(chunkBegin + chunkSize, itemCount));
+}
+
+// exclusive prefix sum of one value per invocation, total is the sum over the workgroup
+uint workgroupExclusiveScan(uint value, out uint total)
+{
+    workgroupScanSums[gl_LocalInvocationIndex] = value;
+    barrier();
+
+    // inclusive Hillis-Steele scan
+    for(uint stride = 1; stride < WORKGROUP_SCAN_SIZE; stride <<= 1)
+    {
+        const uint addend = gl_LocalInvocationIndex >= stride ? workgroupScanSums[gl_LocalInvocationIndex - stride] : 0;
+        barrier();
+        workgroupScanSums[gl_LocalInvocationIndex] += addend;
+        barrier();
+    }
+
+    total = workgroupScanSums[WORKGROUP_SCAN_SIZE - 1];
+    return workgroupScanSums[gl_LocalInvocationIndex] - value;
+}
+
+#endif
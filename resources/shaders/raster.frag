@@ -1,11 +1,8 @@
 #version 460
 
-layout(push_constant) uniform PushConstants 
-{
-    mat4 matrixVP; 
-    vec3 lightDirection;
-    uint mipLevelCount;
-};
+#extension GL_GOOGLE_include_directive : require
+
+#include "include/pushConstants.glsl"
 
 layout(location = 0) out vec4 fragColor;
 
@@ -0,0 +1,11 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : require
+
+#include "include/visibilityBuffer.glsl"
+
+// no fragment outputs and no attachments, the atomic min is the depth test
+void main()
+{
+    imageAtomicMin(visibilityBuffer, ivec2(gl_FragCoord.xy), packVisibility(linearizeDepth(gl_FragCoord.z), uint(gl_PrimitiveID)));
+}
@@ -0,0 +1,14 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+#extension GL_EXT_shader_image_int64 : require
+
+#define VISIBILITY_BUFFER_64
+#include "include/visibilityBuffer.glsl"
+
+// no fragment outputs and no attachments, the atomic min is the depth test
+void main()
+{
+    imageAtomicMin(visibilityBuffer, ivec2(gl_FragCoord.xy), packVisibility(linearizeDepth(gl_FragCoord.z), uint(gl_PrimitiveID)));
+}
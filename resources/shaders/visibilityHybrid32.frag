@@ -0,0 +1,11 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : require
+
+#include "include/visibilityBuffer.glsl"
+
+// large faces of the hybrid visibility buffer, drawn compacted, so the primitive id is mapped back to the face of the model
+void main()
+{
+    imageAtomicMin(visibilityBuffer, ivec2(gl_FragCoord.xy), packVisibility(linearizeDepth(gl_FragCoord.z), hiZRejectedFaces[gl_PrimitiveID]));
+}
@@ -0,0 +1,14 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+#extension GL_EXT_shader_image_int64 : require
+
+#define VISIBILITY_BUFFER_64
+#include "include/visibilityBuffer.glsl"
+
+// large faces of the hybrid visibility buffer, drawn compacted, so the primitive id is mapped back to the face of the model
+void main()
+{
+    imageAtomicMin(visibilityBuffer, ivec2(gl_FragCoord.xy), packVisibility(linearizeDepth(gl_FragCoord.z), hiZRejectedFaces[gl_PrimitiveID]));
+}
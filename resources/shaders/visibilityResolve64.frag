@@ -0,0 +1,25 @@
+#version 460
+
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
+#extension GL_EXT_shader_image_int64 : require
+
+#define VISIBILITY_BUFFER_64
+#include "include/visibilityBuffer.glsl"
+
+layout(location = 0) out vec4 fragColor;
+
+// shades every pixel exactly once, from the primitive left in the visibility buffer
+void main()
+{
+    const VisibilityValue visibility = imageLoad(visibilityBuffer, ivec2(gl_FragCoord.xy)).x;
+    if (visibility == emptyVisibility)
+        discard;
+
+    const uint primitiveId = unpackPrimitiveId(visibility);
+    const vec3 v0 = pos[index[3 * primitiveId]].xyz;
+    const vec3 v1 = pos[index[3 * primitiveId + 1]].xyz;
+    const vec3 v2 = pos[index[3 * primitiveId + 2]].xyz;
+    const vec3 N = normalize(cross(v1 - v0, v2 - v1));
+    fragColor = vec4(dot(N, lightDirection));
+}
@@ -1,13 +1,10 @@
 #version 460
 
-layout(location = 0) in vec4 pos;
+#extension GL_GOOGLE_include_directive : require
 
-layout(push_constant) uniform PushConstants 
-{
-    mat4 matrixVP; 
-    vec3 lightDirection;
-    uint mipLevelCount;
-};
+#include "include/pushConstants.glsl"
+
+layout(location = 0) in vec4 pos;
 
 void main()
 {
@@ -10,6 +10,7 @@ target("BuiltinResources")
     -- so that external projects can get paths
     add_files("./empty.cpp")
     add_includedirs("./shaders/compiled", {public = true})
+    add_includedirs("./shaders/include", {public = true})
     add_includedirs("./models", {public = true})
     add_deps("ShaderBuilder")
 
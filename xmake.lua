@@ -17,4 +17,5 @@ target("rapidobj")
 
 includes("./resources")
 includes("./editor")
+includes("./headless")
 includes("./engine")
\ No newline at end of file